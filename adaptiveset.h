@@ -0,0 +1,615 @@
+#ifndef ADAPTIVESET_H
+#define ADAPTIVESET_H
+
+#include "set.h"
+#include "openhashset.h"
+#include "flatset.h"
+
+#include <iostream>
+#include <iterator>
+#include <cstddef>
+#include <type_traits>
+#include <atomic>
+
+/**
+  @brief Soglie di conversione di un Set adattivo
+
+  Le soglie sono separate (grow_size > shrink_size) per evitare conversioni continue attorno
+  allo stesso numero di elementi: ogni conversione costa O(n) ed e' ripagata da almeno
+  O(n) operazioni.
+*/
+struct adaptive_thresholds
+{
+  unsigned int grow_size;       ///< passa a Large quando il Set supera grow_size elementi
+  unsigned int shrink_size;     ///< torna alla lista quando il Set scende sotto shrink_size elementi (0 = mai)
+  unsigned int lookup_count;    ///< passa a Large dopo lookup_count ricerche sulla lista (0 = mai)
+  unsigned int lookup_min_size; ///< ... purche' il Set abbia almeno lookup_min_size elementi
+
+  /**
+    @brief Costruttore con le soglie di default
+  */
+  adaptive_thresholds() : grow_size(32), shrink_size(8), lookup_count(64), lookup_min_size(12) {}
+};
+
+/**
+  @brief classe Set (AdaptiveStorage)
+
+  La classe implementa un Set di elementi generici T unici che cambia rappresentazione in base
+  all'uso: finche' e' piccolo e' una lista concatenata (Set<T, Equals>), quando supera
+  grow_size elementi o riceve molte ricerche viene convertito nello storage Large, e torna
+  alla lista se scende sotto shrink_size elementi.
+
+  Le conversioni avvengono solo nei metodi non const (add, remove, set_thresholds, optimize) e
+  invalidano gli iteratori. Le ricerche const si limitano a contarsi: la conversione dovuta alle
+  ricerche e' rimandata alla successiva add/remove o a optimize().
+  Lo storage Large deve essere utilizzabile con T ed Equals (es. HashStorage richiede un hash di T,
+  FlatStorage un ordinamento).
+*/
+template <typename T, typename Equals, typename Large>
+class Set<T, Equals, AdaptiveStorage<Large> >
+{
+  typedef Set<T, Equals, ListStorage> small_set;
+  typedef Set<T, Equals, Large> large_set;
+
+  /**
+    @brief Converte la lista nello storage Large
+
+    @post _small vuoto, _large contiene tutti gli elementi
+
+    @throw std::bad_alloc possibile eccezione di allocazione (il Set resta una lista)
+  */
+  void to_large()
+  {
+    SET_TRY
+    {
+      for (typename small_set::const_iterator it = _small.begin(); it != _small.end(); ++it)
+        _large.add(*it);
+    }
+    SET_CATCH_ALL
+    {
+      _large.clear();
+      SET_RETHROW();
+    }
+    _small.clear();
+    _is_small = false;
+    _lookups = 0;
+    ++_conversions;
+  }
+
+  /**
+    @brief Converte lo storage Large nella lista
+
+    @post _large vuoto, _small contiene tutti gli elementi
+
+    @throw std::bad_alloc possibile eccezione di allocazione (il Set resta nello storage Large)
+  */
+  void to_small()
+  {
+    SET_TRY
+    {
+      for (typename large_set::const_iterator it = _large.begin(); it != _large.end(); ++it)
+        _small.add(*it);
+    }
+    SET_CATCH_ALL
+    {
+      _small.clear();
+      SET_RETHROW();
+    }
+    _large.clear();
+    _is_small = true;
+    _lookups = 0;
+    ++_conversions;
+  }
+
+  /**
+    @brief Indica se la lista ha ricevuto abbastanza ricerche da convenire lo storage Large
+
+    @return true se va convertita per numero di ricerche
+  */
+  bool lookup_heavy() const
+  {
+    return _is_small && _thresholds.lookup_count != 0 &&
+           _lookups.load(std::memory_order_relaxed) >= _thresholds.lookup_count &&
+           _small.size() >= _thresholds.lookup_min_size;
+  }
+
+  /**
+    @brief Converte la lista se ha ricevuto molte ricerche
+
+    Se la conversione fallisce per mancanza di memoria il Set resta una lista.
+  */
+  void apply_lookups()
+  {
+    if (!lookup_heavy())
+      return;
+    SET_TRY
+    {
+      to_large();
+    }
+    SET_CATCH_ALL
+    {
+      _lookups = 0;
+    }
+  }
+
+  /**
+    @brief Applica le soglie di dimensione alla rappresentazione corrente
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void rebalance()
+  {
+    if (_is_small && _small.size() > _thresholds.grow_size)
+      to_large();
+    else if (!_is_small && _large.size() < _thresholds.shrink_size)
+      to_small();
+  }
+
+  small_set _small;                                ///< rappresentazione a lista (vuota se !_is_small)
+  large_set _large;                                ///< rappresentazione Large (vuota se _is_small)
+  bool _is_small;                                  ///< true se il Set e' rappresentato da _small
+  mutable std::atomic<unsigned int> _lookups;      ///< ricerche sulla lista dall'ultima conversione
+  unsigned int _conversions;                       ///< numero di conversioni effettuate
+  adaptive_thresholds _thresholds;       ///< soglie di conversione
+
+public:
+  /**
+    @brief Costruttore di default.
+
+    @param thresholds soglie di conversione
+
+    @post Set vuoto rappresentato da una lista
+  */
+  explicit Set(const adaptive_thresholds &thresholds = adaptive_thresholds())
+      : _is_small(true), _lookups(0), _conversions(0), _thresholds(thresholds) {}
+
+  /**
+    @brief Copy constructor
+
+    Mantiene la rappresentazione e le soglie di other.
+
+    @param other Set da copiare
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  Set(const Set &other)
+      : _small(other._small), _large(other._large), _is_small(other._is_small), _lookups(0),
+        _conversions(0), _thresholds(other._thresholds) {}
+
+  /**
+    @brief Costruttore con coppia di iteratori generici
+
+    @param beg iteratore all'inizio della sequenza
+    @param end iteratore alla fine della sequenza
+
+    @post Set chiamante contiene tutti e soli gli elementi della sequenza tra beg e end
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Q>
+  Set(Q beg, Q end) : _is_small(true), _lookups(0), _conversions(0)
+  {
+    while (beg != end)
+    {
+      add(static_cast<T>(*beg));
+      ++beg;
+    }
+  }
+
+  /**
+    @brief Operatore di assegnamento
+
+    @param other Set da copiare
+
+    @return reference al Set this
+  */
+  Set &operator=(const Set &other)
+  {
+    if (this != &other)
+    {
+      Set tmp(other);
+      _small = tmp._small;
+      _large = tmp._large;
+      _is_small = tmp._is_small;
+      _lookups = 0;
+      _thresholds = tmp._thresholds;
+    }
+    return *this;
+  }
+
+  /**
+    @brief Distruttore
+  */
+  ~Set() {}
+
+  /**
+    @brief Svuota il Set e torna alla rappresentazione a lista
+
+    @post Set vuoto
+  */
+  void clear()
+  {
+    _small.clear();
+    _large.clear();
+    _is_small = true;
+    _lookups = 0;
+  }
+
+  /**
+    @brief Numero di elementi nel Set
+
+    @return numero di elementi nel Set
+  */
+  unsigned int size() const
+  {
+    return _is_small ? _small.size() : _large.size();
+  }
+
+  /**
+    @brief Indica se il Set e' rappresentato dalla lista
+
+    @return true se la rappresentazione corrente e' la lista, false se e' Large
+  */
+  bool is_small() const
+  {
+    return _is_small;
+  }
+
+  /**
+    @brief Nome della rappresentazione corrente
+
+    @return "list" oppure il nome dello storage Large (vedi storage_name)
+  */
+  const char *representation() const
+  {
+    return _is_small ? storage_name<ListStorage>::value() : storage_name<Large>::value();
+  }
+
+  /**
+    @brief Numero di conversioni effettuate dalla costruzione del Set
+
+    @return numero di conversioni tra lista e Large
+  */
+  unsigned int conversions() const
+  {
+    return _conversions;
+  }
+
+  /**
+    @brief Soglie di conversione correnti
+
+    @return reference alle soglie
+  */
+  const adaptive_thresholds &thresholds() const
+  {
+    return _thresholds;
+  }
+
+  /**
+    @brief Cambia le soglie di conversione e le applica subito
+
+    @param thresholds nuove soglie
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void set_thresholds(const adaptive_thresholds &thresholds)
+  {
+    _thresholds = thresholds;
+    rebalance();
+  }
+
+  /**
+    @brief Applica subito tutte le soglie, comprese quelle sul numero di ricerche
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void optimize()
+  {
+    rebalance();
+    apply_lookups();
+  }
+
+  /**
+     @brief Operatore di lettura dell'elemento in posizione index
+
+     @param index indice dell'elemento da leggere
+
+     @return reference all'elemento in posizione index
+
+     @throw myexcp::myexcp_domain_error se viene passato un Set vuoto
+     @throw myexcp::myexcp_out_of_range se viene passato un indice out of bounds
+   */
+  const T &operator[](int index) const
+  {
+    if (_is_small)
+      return _small[index];
+    return _large[index];
+  }
+
+  /**
+    @brief Operatore di confronto (uguaglianza) tra due Set
+
+    I due Set possono avere rappresentazioni diverse.
+
+    @param other Set da confrontare
+
+    @return true se other e il Set chiamante contengono gli stessi elementi
+  */
+  bool operator==(const Set &other) const
+  {
+    if (size() != other.size())
+      return false;
+    if (_is_small && other._is_small)
+      return _small == other._small;
+    if (!_is_small && !other._is_small)
+      return _large == other._large;
+
+    const large_set &big = _is_small ? other._large : _large;
+    const small_set &list = _is_small ? _small : other._small;
+    for (typename small_set::const_iterator it = list.begin(); it != list.end(); ++it)
+      if (!big.find(*it))
+        return false;
+    return true;
+  }
+
+  /**
+    @brief Aggiunge un elemento nel set assicurandosi che non sia gia' presente
+
+    @param val valore da inserire nel set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void add(const T &val)
+  {
+    if (_is_small)
+    {
+      _small.add(val);
+      if (_small.size() > _thresholds.grow_size)
+        to_large();
+      else
+        apply_lookups();
+    }
+    else
+      _large.add(val);
+  }
+
+  /**
+    @brief Rimuove (se presente) un elemento dal set.
+
+    @param val valore da rimuovere dal set
+
+    @return true se val e' stato rimosso, false altrimenti
+  */
+  bool remove(const T &val)
+  {
+    if (_is_small)
+    {
+      bool removed = _small.remove(val);
+      apply_lookups();
+      return removed;
+    }
+
+    bool removed = _large.remove(val);
+    if (removed && _large.size() < _thresholds.shrink_size)
+    {
+      SET_TRY
+      {
+        to_small();
+      }
+      SET_CATCH_ALL
+      {
+        // la conversione e' solo un'ottimizzazione: il Set resta valido nello storage Large
+      }
+    }
+    return removed;
+  }
+
+  /**
+    @brief ricerca di un valore nel Set
+
+    Non cambia mai rappresentazione: sulla lista conta soltanto le ricerche, e superata la
+    soglia lookup_count la conversione avviene alla successiva add/remove o con optimize().
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool find(const T &val) const
+  {
+    if (!_is_small)
+      return _large.find(val);
+
+    _lookups.fetch_add(1, std::memory_order_relaxed);
+    return _small.find(val);
+  }
+
+  /**
+    @brief Sinonimo di find
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool contains(const T &val) const
+  {
+    return find(val);
+  }
+
+  /**
+    @brief stampa del Set nello standard output
+
+    Overloading dell'operatore << dello standard output per stampa del Set
+
+    @return ostream con il Set da stampare
+  */
+  friend std::ostream &operator<<(std::ostream &os, const Set &mset)
+  {
+    if (mset._is_small)
+      return os << mset._small;
+    return os << mset._large;
+  }
+
+  /**
+  @brief classe const_iterator
+
+  Classe interna di iteratori costanti (sola lettura) che inoltra all'iteratore della
+  rappresentazione corrente
+
+  */
+  class const_iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T val_type;
+    typedef ptrdiff_t difference_type;
+    typedef const T *pointer;
+    typedef const T &reference;
+
+    /**
+      @brief Costruttore di default.
+    */
+    const_iterator() : _small(true) {}
+
+    /**
+      @brief Copy constructor
+
+      @param other iteratore da copiare
+    */
+    const_iterator(const const_iterator &other)
+        : _s(other._s), _l(other._l), _small(other._small) {}
+
+    /**
+      @brief Operatore di assegnamento
+
+      @param other iteratore da copiare
+
+      @return reference all'iteratore this
+    */
+    const_iterator &operator=(const const_iterator &other)
+    {
+      _s = other._s;
+      _l = other._l;
+      _small = other._small;
+      return *this;
+    }
+
+    /**
+      @brief Distruttore
+    */
+    ~const_iterator() {}
+
+    /**
+      @brief Operatore di dereferenziamento
+
+      @return reference al valore dell'elemento corrente
+
+      @throw myexcp::myexcp_domain_error se viene dereferenziato end()
+    */
+    reference operator*() const
+    {
+      return _small ? *_s : *_l;
+    }
+
+    /**
+      @brief Operatore freccia
+
+      @return puntatore al valore dell'elemento corrente
+    */
+    pointer operator->() const
+    {
+      return &(operator*());
+    }
+
+    /**
+      @brief Operatore post incremento
+
+      @return copia dell'iteratore this (prima di essere incrementato)
+    */
+    const_iterator operator++(int)
+    {
+      const_iterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    /**
+      @brief Operatore pre incremento
+
+      @return reference all'iteratore this (incrementato)
+    */
+    const_iterator &operator++()
+    {
+      if (_small)
+        ++_s;
+      else
+        ++_l;
+      return *this;
+    }
+
+    /**
+    @brief Operatore di confronto (uguaglianza) tra due iteratori
+
+    @return true se i due iteratori puntano allo stesso elemento
+    */
+    bool operator==(const const_iterator &other) const
+    {
+      if (_small != other._small)
+        return false;
+      return _small ? _s == other._s : _l == other._l;
+    }
+
+    /**
+    @brief Operatore di confronto (disuguaglianza) tra due iteratori
+
+    @return true se i due iteratori non puntano allo stesso elemento
+    */
+    bool operator!=(const const_iterator &other) const
+    {
+      return !(*this == other);
+    }
+
+  private:
+    typename small_set::const_iterator _s; ///< iteratore sulla lista
+    typename large_set::const_iterator _l; ///< iteratore sullo storage Large
+    bool _small;                           ///< true se si itera sulla lista
+
+    friend class Set;
+
+    const_iterator(const typename small_set::const_iterator &s) : _s(s), _small(true) {}
+
+    const_iterator(const typename large_set::const_iterator &l) : _l(l), _small(false) {}
+  };
+
+  /**
+      @brief Iteratore all'inizio del Set
+
+      @return copia dell'iteratore all'inizio del Set
+  */
+  const_iterator begin() const
+  {
+    if (_is_small)
+      return const_iterator(_small.begin());
+    return const_iterator(_large.begin());
+  }
+
+  /**
+      @brief Iteratore alla fine del Set
+
+      @return copia dell'iteratore alla fine del Set
+  */
+  const_iterator end() const
+  {
+    if (_is_small)
+      return const_iterator(_small.end());
+    return const_iterator(_large.end());
+  }
+};
+
+/**
+  @brief Set adattivo
+
+  Nome breve di Set<T, Equals, AdaptiveStorage<Large> >.
+*/
+template <typename T, typename Equals, typename Large = HashStorage<> >
+using AdaptiveSet = Set<T, Equals, AdaptiveStorage<Large> >;
+
+#endif
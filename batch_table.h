@@ -0,0 +1,155 @@
+#ifndef BATCH_TABLE_H
+#define BATCH_TABLE_H
+
+#include "storage.h"
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+/**
+  @brief Struttura batch_table
+
+  Tabella hash temporanea (indirizzamento aperto) costruita su una sequenza di valori.
+  Le operazioni a blocchi dei Set la usano per confrontare l'intera sequenza con il Set in una
+  sola passata. Hash deve essere coerente con Equals; l'hash viene rimescolato con set_mix prima
+  di sceglierne la cella, quindi va bene anche l'identita' di std::hash sugli interi.
+*/
+template <typename T, typename Equals, typename Hash>
+struct batch_table
+{
+  typedef typename std::remove_cv<T>::type value_type;
+
+  static const std::size_t PREFETCH_DISTANCE = 8; ///< elementi di anticipo per il prefetch delle celle
+
+  std::vector<value_type> vals;    ///< valori della sequenza
+  std::vector<std::size_t> hashes; ///< hash dei valori
+  std::vector<std::size_t> slots;  ///< indici in vals, vals.size() = cella vuota
+  std::size_t mask;                ///< numero di celle - 1 (potenza di 2)
+  Hash hash;                       ///< funtore di hash
+  Equals equals;                   ///< funtore di uguaglianza
+
+  /**
+    @brief Costruttore con coppia di iteratori generici
+
+    Copia la sequenza e ne calcola gli hash; la tabella e' inizialmente vuota.
+
+    @param first iteratore all'inizio della sequenza
+    @param last iteratore alla fine della sequenza
+    @param h funtore di hash
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Iter>
+  batch_table(Iter first, Iter last, const Hash &h) : mask(1), hash(h)
+  {
+    while (first != last)
+    {
+      vals.push_back(static_cast<T>(*first));
+      ++first;
+    }
+    hashes.resize(vals.size());
+    for (std::size_t i = 0; i < vals.size(); ++i)
+      hashes[i] = hash(vals[i]);
+
+    while (mask < 2 * vals.size())
+      mask <<= 1;
+    slots.assign(mask, vals.size());
+    --mask;
+  }
+
+  /**
+    @brief Inserisce nella tabella tutti i valori della sequenza
+
+    Le celle dei valori successivi vengono precaricate mentre si inserisce quello corrente.
+
+    @param rep vettore di destinazione: rep[i] = indice del primo valore uguale all'i-esimo
+
+    @return numero di valori distinti
+  */
+  std::size_t insert_all(std::vector<std::size_t> &rep)
+  {
+    std::size_t distinct = 0;
+    rep.resize(vals.size());
+    for (std::size_t i = 0; i < vals.size(); ++i)
+    {
+      if (i + PREFETCH_DISTANCE < vals.size())
+        __builtin_prefetch(home(hashes[i + PREFETCH_DISTANCE]));
+      rep[i] = insert(i);
+      if (rep[i] == i)
+        ++distinct;
+    }
+    return distinct;
+  }
+
+  /**
+    @brief Inserisce nella tabella l'i-esimo valore della sequenza
+
+    @param i indice del valore da inserire
+
+    @return i se il valore e' stato inserito, altrimenti l'indice del valore uguale gia' presente
+  */
+  std::size_t insert(std::size_t i)
+  {
+    std::size_t slot = slot_of(hashes[i]);
+    while (slots[slot] != vals.size())
+    {
+      std::size_t j = slots[slot];
+      if (hashes[j] == hashes[i] && equals(vals[j], vals[i]))
+        return j;
+      slot = (slot + 1) & mask;
+    }
+    slots[slot] = i;
+    return i;
+  }
+
+  /**
+    @brief Indice della cella da cui parte la ricerca di un hash
+
+    Senza rimescolamento chiavi con i bit bassi uguali (es. multipli di 2^16) finirebbero tutte
+    nelle stesse celle e le sequenze di sondaggio diventerebbero lunghe quanto la tabella.
+
+    @param h hash del valore cercato
+
+    @return indice della cella iniziale
+  */
+  std::size_t slot_of(std::size_t h) const
+  {
+    return static_cast<std::size_t>(set_mix(h)) & mask;
+  }
+
+  /**
+    @brief Cella della tabella da cui parte la ricerca di un hash
+
+    @param h hash del valore cercato
+
+    @return puntatore alla cella (utile per il prefetch)
+  */
+  const std::size_t *home(std::size_t h) const
+  {
+    return &slots[slot_of(h)];
+  }
+
+  /**
+    @brief Cerca nella tabella un elemento del Set
+
+    @param val elemento da cercare
+    @param h hash di val
+
+    @return indice del valore uguale a val, vals.size() se non esiste
+  */
+  std::size_t find(const T &val, std::size_t h) const
+  {
+    std::size_t slot = slot_of(h);
+    while (slots[slot] != vals.size())
+    {
+      std::size_t j = slots[slot];
+      if (hashes[j] == h && equals(val, vals[j]))
+        return j;
+      slot = (slot + 1) & mask;
+    }
+    return vals.size();
+  }
+};
+
+#endif
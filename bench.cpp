@@ -0,0 +1,366 @@
+#include "set.h"
+#include "shardedset.h"
+#include "skiplistset.h"
+#include "constexprset.h"
+#include "frozenset.h"
+#include "openhashset.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+  @brief Funtore di uguaglianza tra interi che conta i confronti effettuati
+
+  Il numero di confronti per find e' la lunghezza media della scansione della lista.
+*/
+struct counting_int_equal
+{
+  static unsigned long long calls;
+
+  bool operator()(int a, int b) const
+  {
+    ++calls;
+    return a == b;
+  }
+};
+
+unsigned long long counting_int_equal::calls = 0;
+
+/**
+  @brief Genera una traccia di ricerche con distribuzione di Zipf
+
+  La chiave di rango r (0 = piu' frequente) viene cercata con probabilita' proporzionale a 1/(r+1)^s;
+  i ranghi sono assegnati alle chiavi in ordine casuale.
+
+  @param keys numero di chiavi distinte
+  @param lookups lunghezza della traccia
+  @param s esponente della distribuzione
+  @param seed seme del generatore
+
+  @return sequenza di chiavi da cercare
+*/
+std::vector<int> zipf_trace(int keys, int lookups, double s, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::vector<int> rank_to_key(keys);
+  for (int i = 0; i < keys; ++i)
+    rank_to_key[i] = i;
+  std::shuffle(rank_to_key.begin(), rank_to_key.end(), gen);
+
+  std::vector<double> cdf(keys);
+  double sum = 0;
+  for (int r = 0; r < keys; ++r)
+  {
+    sum += 1.0 / std::pow(r + 1, s);
+    cdf[r] = sum;
+  }
+
+  std::uniform_real_distribution<double> unif(0, sum);
+  std::vector<int> trace(lookups);
+  for (int i = 0; i < lookups; ++i)
+  {
+    int r = std::lower_bound(cdf.begin(), cdf.end(), unif(gen)) - cdf.begin();
+    trace[i] = rank_to_key[std::min(r, keys - 1)];
+  }
+  return trace;
+}
+
+/**
+  @brief Esegue la traccia su un Set con la politica indicata
+
+  @param name nome della politica da stampare
+  @param policy politica di riorganizzazione
+  @param keys numero di chiavi nel Set
+  @param trace sequenza di chiavi da cercare
+*/
+void run(const char *name, reorder_policy policy, int keys, const std::vector<int> &trace)
+{
+  Set<int, counting_int_equal> set;
+  for (int i = 0; i < keys; ++i)
+    set.add(i);
+  set.set_reorder(policy);
+
+  counting_int_equal::calls = 0;
+  unsigned int hits = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < trace.size(); ++i)
+    hits += set.find_and_promote(trace[i]);
+  std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+
+  double ns = std::chrono::duration<double, std::nano>(stop - start).count() / trace.size();
+  std::printf("  %-14s %10.1f %12.1f %8u\n", name, double(counting_int_equal::calls) / trace.size(), ns, hits);
+}
+
+/**
+  @brief Un OpenHashSet protetto da un unico mutex, termine di confronto per ShardedSet
+*/
+struct locked_set
+{
+  std::mutex lock;
+  OpenHashSet<int, std::equal_to<int> > set;
+
+  bool add(int v)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    unsigned int before = set.size();
+    set.add(v);
+    return set.size() != before;
+  }
+
+  bool remove(int v)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    return set.remove(v);
+  }
+
+  bool find(int v)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    return set.find(v);
+  }
+};
+
+/**
+  @brief Traffico di ingest misto da piu' thread: 80% find, 10% add, 10% remove
+
+  @param set Set concorrente (ShardedSet o locked_set)
+  @param threads numero di thread
+  @param ops operazioni per thread
+
+  @return milioni di operazioni al secondo
+*/
+template <typename S>
+double ingest(S &set, int threads, int ops)
+{
+  std::vector<std::thread> workers;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; ++t)
+    workers.push_back(std::thread([&set, t, ops]
+                                  {
+      std::mt19937 gen(t);
+      std::uniform_int_distribution<int> key(0, 1 << 20), op(0, 9);
+      for (int i = 0; i < ops; ++i)
+      {
+        int k = key(gen), o = op(gen);
+        if (o == 0)
+          set.add(k);
+        else if (o == 1)
+          set.remove(k);
+        else
+          set.find(k);
+      } }));
+  for (int t = 0; t < threads; ++t)
+    workers[t].join();
+  std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+  return threads * double(ops) / std::chrono::duration<double, std::micro>(stop - start).count();
+}
+
+/**
+  @brief Destinazione dei risultati delle query, per evitare che il compilatore le elimini
+*/
+volatile unsigned long long bench_sink;
+
+/**
+  @brief Query ordinate: skip list contro scansione lineare del Set a lista
+
+  Per ogni dimensione misura count_in_range e l'accesso per rango (operator[]) su SkipListSet
+  e le stesse query su Set a lista (passata con const_iterator e operator[] O(index)).
+
+  @param n numero di elementi
+  @param queries numero di query
+*/
+void ordered_queries(int n, int queries)
+{
+  std::mt19937 gen(7);
+  std::vector<int> keys(n);
+  for (int i = 0; i < n; ++i)
+    keys[i] = i * 2;
+  std::shuffle(keys.begin(), keys.end(), gen);
+
+  Set<int, std::equal_to<int> > list;
+  SkipListSet<int, std::equal_to<int> > skip;
+  list.insert(keys.begin(), keys.end());
+  for (int i = 0; i < n; ++i)
+    skip.add(keys[i]);
+
+  std::uniform_int_distribution<int> key(0, 2 * n), pos(0, n - 1);
+  std::vector<int> lo(queries), hi(queries), idx(queries);
+  for (int q = 0; q < queries; ++q)
+  {
+    lo[q] = key(gen);
+    hi[q] = lo[q] + 2 * n / 10;
+    idx[q] = pos(gen);
+  }
+
+  unsigned long long check = 0;
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  for (int q = 0; q < queries; ++q)
+    for (Set<int, std::equal_to<int> >::const_iterator it = list.begin(); it != list.end(); ++it)
+      check += (*it >= lo[q] && *it < hi[q]);
+  std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+  for (int q = 0; q < queries; ++q)
+    check -= skip.count_in_range(lo[q], hi[q]);
+  std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+  for (int q = 0; q < queries; ++q)
+    check += list[idx[q]];
+  std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+  for (int q = 0; q < queries; ++q)
+    check += skip[idx[q]];
+  std::chrono::steady_clock::time_point t4 = std::chrono::steady_clock::now();
+
+  bench_sink = check;
+  std::printf("  %-8d %12.1f %12.1f %12.1f %12.1f\n", n,
+              std::chrono::duration<double, std::nano>(t1 - t0).count() / queries,
+              std::chrono::duration<double, std::nano>(t2 - t1).count() / queries,
+              std::chrono::duration<double, std::nano>(t3 - t2).count() / queries,
+              std::chrono::duration<double, std::nano>(t4 - t3).count() / queries);
+}
+
+/**
+  @brief Tabella di parole chiave: Set a lista costruito con add contro StaticSet costruito a tempo di compilazione
+
+  @param lookups numero di ricerche (meta' parole chiave, meta' identificatori)
+*/
+void keyword_lookup(int lookups)
+{
+  static constexpr auto keywords = make_static_set<std::string_view>(
+      {"alignas", "auto", "bool", "break", "case", "catch", "char", "class", "const", "continue",
+       "default", "delete", "do", "double", "else", "enum", "explicit", "false", "float", "for",
+       "friend", "if", "inline", "int", "long", "namespace", "new", "return", "static", "struct",
+       "switch", "template", "this", "throw", "true", "try", "typedef", "using", "void", "while"});
+
+  Set<std::string_view, std::equal_to<std::string_view> > list;
+  for (const std::string_view *it = keywords.begin(); it != keywords.end(); ++it)
+    list.add(*it);
+
+  const std::string_view words[] = {"return", "value", "while", "index", "template", "node", "int", "result"};
+  std::vector<std::string_view> trace(lookups);
+  std::mt19937 gen(11);
+  for (int i = 0; i < lookups; ++i)
+    trace[i] = words[gen() % 8];
+
+  unsigned long long hits = 0;
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; ++i)
+    hits += list.find(trace[i]);
+  std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; ++i)
+    hits += keywords.find(trace[i]);
+  std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+  bench_sink = hits;
+  std::printf("  %-8zu %12.1f %12.1f\n", keywords.size(),
+              std::chrono::duration<double, std::nano>(t1 - t0).count() / lookups,
+              std::chrono::duration<double, std::nano>(t2 - t1).count() / lookups);
+}
+
+/**
+  @brief Ricerche su un Set che non cambia piu': lista, OpenHashSet e FrozenSet (freeze)
+
+  @param n numero di elementi
+  @param lookups numero di ricerche (meta' presenti, meta' assenti)
+*/
+void frozen_lookup(int n, int lookups)
+{
+  std::mt19937 gen(13);
+  Set<int, std::equal_to<int> > list;
+  OpenHashSet<int, std::equal_to<int> > hash;
+  std::vector<int> keys(n);
+  for (int i = 0; i < n; ++i)
+  {
+    keys[i] = i * 2;
+    hash.add(i * 2);
+  }
+  list.insert(keys.begin(), keys.end());
+  std::chrono::steady_clock::time_point b0 = std::chrono::steady_clock::now();
+  FrozenSet<int, std::equal_to<int> > frozen = freeze(list);
+  std::chrono::steady_clock::time_point b1 = std::chrono::steady_clock::now();
+
+  std::vector<int> trace(lookups);
+  std::uniform_int_distribution<int> key(0, 2 * n - 1);
+  for (int i = 0; i < lookups; ++i)
+    trace[i] = key(gen);
+
+  // la lista e' lineare: per n grande basta un campione della traccia
+  int list_lookups = lookups / (n / 1000 * n / 1000);
+  unsigned long long hits = 0;
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < list_lookups; ++i)
+    hits += list.find(trace[i]);
+  std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; ++i)
+    hits += hash.find(trace[i]);
+  std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; ++i)
+    hits += frozen.find(trace[i]);
+  std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+
+  bench_sink = hits;
+  std::printf("  %-8d %12.1f %12.1f %12.1f %12.2f\n", n,
+              std::chrono::duration<double, std::nano>(t1 - t0).count() / list_lookups,
+              std::chrono::duration<double, std::nano>(t2 - t1).count() / lookups,
+              std::chrono::duration<double, std::nano>(t3 - t2).count() / lookups,
+              std::chrono::duration<double, std::milli>(b1 - b0).count());
+}
+
+int main()
+{
+  const int keys = 2000;
+  const int lookups = 500000;
+  const double exponents[] = {0.8, 1.0, 1.2};
+
+  for (int e = 0; e < 3; ++e)
+  {
+    std::vector<int> trace = zipf_trace(keys, lookups, exponents[e], 42);
+    std::printf("Zipf s = %.1f, %d chiavi, %d find\n", exponents[e], keys, lookups);
+    std::printf("  %-14s %10s %12s %8s\n", "policy", "cmp/find", "ns/find", "hits");
+    run("none", REORDER_NONE, keys, trace);
+    run("move-to-front", REORDER_MOVE_TO_FRONT, keys, trace);
+    run("transpose", REORDER_TRANSPOSE, keys, trace);
+    run("count", REORDER_COUNT, keys, trace);
+    std::printf("\n");
+  }
+
+  std::printf("Query ordinate, ns per query (list = scansione lineare)\n");
+  std::printf("  %-8s %12s %12s %12s %12s\n", "n", "list range", "skip range", "list [i]", "skip [i]");
+  for (int n = 1000; n <= 100000; n *= 10)
+    ordered_queries(n, 200);
+  std::printf("\n");
+
+  std::printf("Parole chiave, ns per find\n");
+  std::printf("  %-8s %12s %12s\n", "keys", "list", "static");
+  keyword_lookup(500000);
+  std::printf("\n");
+
+  std::printf("Set congelato, ns per find (freeze = costruzione del FrozenSet)\n");
+  std::printf("  %-8s %12s %12s %12s %12s\n", "n", "list", "open hash", "frozen", "freeze ms");
+  for (int n = 1000; n <= 100000; n *= 10)
+    frozen_lookup(n, 1000000);
+  std::printf("\n");
+
+  const int ops = 200000;
+  std::printf("Ingest 80%% find / 10%% add / 10%% remove, %d op per thread, %u core\n", ops,
+              std::thread::hardware_concurrency());
+  std::printf("  %-8s %14s %14s\n", "threads", "mutex Mop/s", "sharded Mop/s");
+  for (int threads = 1; threads <= 64; threads *= 2)
+  {
+    locked_set locked;
+    ShardedSet<int, std::equal_to<int> > sharded(256);
+    for (int k = 0; k < (1 << 20); k += 2)
+    {
+      locked.add(k);
+      sharded.add(k);
+    }
+    double m = ingest(locked, threads, ops);
+    double s = ingest(sharded, threads, ops);
+    std::printf("  %-8d %14.2f %14.2f\n", threads, m, s);
+  }
+  return 0;
+}
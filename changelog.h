@@ -0,0 +1,242 @@
+#ifndef CHANGELOG_H
+#define CHANGELOG_H
+
+#include "storage.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+  @brief Tipo di modifica registrata nel change log
+*/
+enum change_kind
+{
+  CHANGE_ADD,   ///< elemento aggiunto
+  CHANGE_REMOVE ///< elemento rimosso
+};
+
+/**
+  @brief Una modifica effettiva di un Set
+*/
+template <typename V>
+struct set_change
+{
+  unsigned long long seq; ///< numero di sequenza (da 1, crescente senza buchi)
+  change_kind kind;       ///< aggiunta o rimozione
+  V val;                  ///< elemento aggiunto o rimosso
+
+  set_change(unsigned long long s, change_kind k, const V &v) : seq(s), kind(k), val(v) {}
+};
+
+/**
+  @brief Interfaccia di un osservatore delle modifiche registrate in un change_log
+
+  Le notifiche avvengono durante la modifica del Set, prima che il nodo venga collegato o
+  scollegato: gli osservatori non devono leggere il Set osservato ne' lanciare eccezioni.
+*/
+template <typename V>
+class change_listener
+{
+public:
+  virtual ~change_listener() {}
+
+  /**
+    @brief Notifica di una modifica appena registrata
+
+    @param change modifica registrata
+  */
+  virtual void on_change(const set_change<V> &change) = 0;
+
+  /**
+    @brief Notifica che il change log sta per essere distrutto
+
+    @param destroyed true se viene distrutto anche il Set osservato
+  */
+  virtual void on_detach(bool destroyed) = 0;
+};
+
+/**
+  @brief classe change_log
+
+  Buffer circolare delle ultime capacity modifiche effettive di un Set, con numeri di sequenza.
+  Un consumatore ricorda l'ultimo numero di sequenza letto e chiede le modifiche successive
+  (changes_since); se nel frattempo sono state sovrascritte deve ricostruirsi dal Set.
+*/
+template <typename V>
+class change_log
+{
+  std::vector<set_change<V> > _ring; ///< modifiche, la piu' vecchia in posizione (_next - 1) % capacity
+  std::size_t _capacity;             ///< numero massimo di modifiche conservate
+  unsigned long long _next;          ///< numero di sequenza della prossima modifica
+  unsigned long long _floor;         ///< primo numero di sequenza affidabile (dopo un record_all fallito)
+
+  std::vector<change_listener<V> *> _listeners; ///< osservatori notificati ad ogni modifica
+
+public:
+  /**
+    @brief Costruttore
+
+    @param capacity numero massimo di modifiche conservate (almeno 1)
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  explicit change_log(std::size_t capacity) : _capacity(capacity != 0 ? capacity : 1), _next(1), _floor(1)
+  {
+    _ring.reserve(_capacity);
+  }
+
+  /**
+    @brief Registra una modifica, sovrascrivendo la piu' vecchia se il buffer e' pieno
+
+    @param kind tipo di modifica
+    @param val elemento aggiunto o rimosso
+
+    @throw eccezione del costruttore di copia di V (la modifica non viene registrata)
+  */
+  void record(change_kind kind, const V &val)
+  {
+    std::size_t pos = (_next - 1) % _capacity;
+    if (_ring.size() < _capacity)
+      _ring.push_back(set_change<V>(_next, kind, val));
+    else
+      _ring[pos] = set_change<V>(_next, kind, val);
+    ++_next;
+
+    for (std::size_t i = 0; i < _listeners.size(); ++i)
+      _listeners[i]->on_change(_ring[pos]);
+  }
+
+  /**
+    @brief Registra un blocco di modifiche preparato dal chiamante (es. assegnamento o clear)
+
+    Le copie degli elementi sono gia' state fatte preparando batch, senza effetti sul log. Se lo
+    spostamento nel buffer lancia un'eccezione (V senza move noexcept) le modifiche gia' registrate
+    del blocco non vengono annullate ma rese irraggiungibili: changes_since riporta il log come
+    incompleto e gli osservatori vengono staccati con on_detach(false), cosi' si ricostruiscono.
+
+    @param batch modifiche da registrare, in ordine (il campo seq viene assegnato qui); svuotato
+
+    @throw eccezione dell'assegnamento di V (il log resta coerente, gli osservatori staccati)
+  */
+  void record_all(std::vector<set_change<V> > &batch)
+  {
+    SET_TRY
+    {
+      for (std::size_t i = 0; i < batch.size(); ++i)
+      {
+        std::size_t pos = (_next - 1) % _capacity;
+        batch[i].seq = _next;
+        if (_ring.size() < _capacity)
+          _ring.push_back(std::move(batch[i]));
+        else
+          _ring[pos] = std::move(batch[i]);
+        ++_next;
+
+        for (std::size_t l = 0; l < _listeners.size(); ++l)
+          _listeners[l]->on_change(_ring[pos]);
+      }
+    }
+    SET_CATCH_ALL
+    {
+      _floor = _next;
+      detach(false);
+      SET_RETHROW();
+    }
+    batch.clear();
+  }
+
+  /**
+    @brief Registra un osservatore
+
+    @param l osservatore da notificare ad ogni modifica
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void subscribe(change_listener<V> *l)
+  {
+    _listeners.push_back(l);
+  }
+
+  /**
+    @brief Rimuove un osservatore (se registrato)
+
+    @param l osservatore da rimuovere
+  */
+  void unsubscribe(change_listener<V> *l)
+  {
+    for (std::size_t i = 0; i < _listeners.size(); ++i)
+      if (_listeners[i] == l)
+      {
+        _listeners.erase(_listeners.begin() + i);
+        return;
+      }
+  }
+
+  /**
+    @brief Avvisa e rimuove tutti gli osservatori, prima di distruggere il change log
+
+    @param destroyed true se viene distrutto anche il Set osservato
+  */
+  void detach(bool destroyed)
+  {
+    std::vector<change_listener<V> *> listeners;
+    listeners.swap(_listeners);
+    for (std::size_t i = 0; i < listeners.size(); ++i)
+      listeners[i]->on_detach(destroyed);
+  }
+
+  /**
+    @brief Numero di sequenza dell'ultima modifica
+
+    @return numero di sequenza dell'ultima modifica registrata, 0 se non ce ne sono
+  */
+  unsigned long long last_sequence() const
+  {
+    return _next - 1;
+  }
+
+  /**
+    @brief Numero di sequenza della modifica piu' vecchia ancora conservata
+
+    @return primo numero di sequenza disponibile (last_sequence() + 1 se il log e' vuoto)
+  */
+  unsigned long long first_sequence() const
+  {
+    unsigned long long first = _next - _ring.size();
+    return first > _floor ? first : _floor;
+  }
+
+  /**
+    @brief Modifiche successive ad un numero di sequenza
+
+    @param since ultimo numero di sequenza gia' letto dal consumatore (0 = nessuno)
+    @param out vettore a cui vengono accodate le modifiche, in ordine di sequenza
+
+    @return true se out contiene tutte le modifiche successive a since, false se alcune sono
+            state sovrascritte o se since e' successivo a last_sequence() (since viene da un log
+            precedente, ad es. prima di set_change_log): vengono accodate solo quelle conservate
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  bool changes_since(unsigned long long since, std::vector<set_change<V> > &out) const
+  {
+    unsigned long long first = first_sequence();
+    bool complete = since + 1 >= first && since <= last_sequence();
+    for (unsigned long long s = complete ? since + 1 : first; s < _next; ++s)
+      out.push_back(_ring[(s - 1) % _capacity]);
+    return complete;
+  }
+
+  /**
+    @brief Numero massimo di modifiche conservate
+
+    @return capacita' del buffer
+  */
+  std::size_t capacity() const
+  {
+    return _capacity;
+  }
+};
+
+#endif
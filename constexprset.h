@@ -0,0 +1,338 @@
+#ifndef CONSTEXPRSET_H
+#define CONSTEXPRSET_H
+
+#include "storage.h"
+#include "perfecthash.h"
+#include "myexcp.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string_view>
+#include <type_traits>
+
+/**
+  @brief Funtore di hash utilizzabile in espressioni costanti (default di StaticSet)
+
+  Interi ed enum vengono mescolati con set_mix; std::string_view, std::string e const char*
+  passano tutti per la versione su std::string_view (FNV-1a), quindi danno lo stesso hash.
+*/
+struct static_hash
+{
+  constexpr std::uint64_t operator()(std::string_view s) const
+  {
+    std::uint64_t h = 0xcbf29ce484222325ull;
+    for (std::size_t i = 0; i < s.size(); ++i)
+    {
+      h ^= static_cast<unsigned char>(s[i]);
+      h *= 0x100000001b3ull;
+    }
+    return set_mix(h);
+  }
+
+  template <typename I, typename = typename std::enable_if<std::is_integral<I>::value || std::is_enum<I>::value>::type>
+  constexpr std::uint64_t operator()(I val) const
+  {
+    return set_mix(static_cast<std::uint64_t>(val));
+  }
+};
+
+/**
+  @brief classe StaticSet
+
+  Set immutabile di al piu' N elementi costruito a tempo di compilazione da una lista letterale
+  (es. una allow-list o una tabella di parole chiave):
+
+    static constexpr auto keywords = make_static_set<std::string_view>({"if", "else", "while"});
+
+  Il costruttore ordina gli elementi, elimina i duplicati e calcola una funzione hash perfetta
+  minimale (hash and displace, vedi perfect_hash): gli elementi sono divisi in bucket dall'hash e
+  ad ogni bucket, dal piu' numeroso, viene assegnato il primo spostamento che manda tutti i suoi
+  elementi in posizioni libere della tabella. find calcola l'hash, legge lo spostamento del bucket
+  e confronta un solo elemento. Se per un bucket non si trova uno spostamento (hash identici) find usa la
+  ricerca binaria sul vettore ordinato.
+
+  Con un costruttore constexpr tutto il lavoro avviene durante la compilazione: l'oggetto non
+  alloca memoria e non ha costo di inizializzazione statica.
+
+  Offre l'interfaccia di lettura dei Set (find, contains, size, operator[], operator==, operator<<,
+  const_iterator ad accesso casuale in ordine crescente, begin, end) ma non add ne' remove.
+
+  T deve essere un tipo letterale con costruttore di default (interi, enum, std::string_view, ...);
+  Less e Hash devono essere utilizzabili in espressioni costanti, con Hash coerente con Less.
+
+  @tparam T tipo degli elementi
+  @tparam N numero di elementi della lista letterale (duplicati compresi)
+  @tparam Less ordinamento stretto degli elementi
+  @tparam Hash funtore di hash constexpr
+*/
+template <typename T, std::size_t N, typename Less = std::less<void>, typename Hash = static_hash>
+class StaticSet
+{
+  static_assert(N > 0, "StaticSet needs at least one element");
+
+  T _vals[N];                ///< elementi ordinati e distinti in [0, _size), valori di default oltre
+  std::size_t _size;         ///< numero di elementi distinti
+  std::uint32_t _slots[N];   ///< posizione nella tabella -> indice in _vals
+  std::uint32_t _disp[N];    ///< spostamento di ogni bucket (tanti bucket quanti elementi)
+  bool _hashed;              ///< false se la funzione hash perfetta non e' stata trovata
+  Less _less;                ///< ordinamento degli elementi
+  Hash _hash;                ///< hash degli elementi
+
+  /**
+    @brief Ripristina la proprieta' di max-heap di _vals[0, n) a partire da root
+
+    @param root radice del sotto-heap
+    @param n dimensione dello heap
+  */
+  constexpr void sift_down(std::size_t root, std::size_t n)
+  {
+    while (2 * root + 1 < n)
+    {
+      std::size_t child = 2 * root + 1;
+      if (child + 1 < n && _less(_vals[child], _vals[child + 1]))
+        ++child;
+      if (!_less(_vals[root], _vals[child]))
+        return;
+      T tmp = _vals[root];
+      _vals[root] = _vals[child];
+      _vals[child] = tmp;
+      root = child;
+    }
+  }
+
+  /**
+    @brief Posizione del primo elemento non minore di val (ricerca binaria senza salti)
+
+    @param val valore da cercare
+
+    @return indice in [0, size()]
+  */
+  template <typename K>
+  constexpr std::size_t lower_index(const K &val) const
+  {
+    const T *base = _vals;
+    std::size_t n = _size;
+    while (n > 1)
+    {
+      std::size_t half = n / 2;
+      base = _less(base[half], val) ? base + half : base;
+      n -= half;
+    }
+    return (base - _vals) + (_less(*base, val) ? 1 : 0);
+  }
+
+  /**
+    @brief Posizione di val in _vals, oppure _size
+
+    @param val valore da cercare
+
+    @return indice dell'elemento equivalente a val, _size se non e' presente
+  */
+  template <typename K>
+  constexpr std::size_t locate(const K &val) const
+  {
+    std::size_t i = 0;
+    if (_hashed)
+    {
+      std::uint64_t h = _hash(val);
+      i = _slots[perfect_hash::slot(h, _disp[perfect_hash::bucket(h, _size)], _size)];
+      if (_less(val, _vals[i]))
+        return _size;
+    }
+    else
+    {
+      i = lower_index(val);
+      if (i == _size || _less(val, _vals[i]))
+        return _size;
+    }
+    return _less(_vals[i], val) ? _size : i;
+  }
+
+  /**
+    @brief Calcola la funzione hash perfetta minimale sugli elementi distinti
+
+    @return false se per qualche bucket non esiste uno spostamento valido
+  */
+  constexpr bool build_hash()
+  {
+    std::uint64_t hashes[N] = {};
+    std::size_t scratch[perfect_hash::scratch_size(N)] = {};
+
+    for (std::size_t i = 0; i < _size; ++i)
+      hashes[i] = _hash(_vals[i]);
+    return perfect_hash::place(hashes, _size, static_cast<std::uint32_t>(16 * _size + 64), _disp, _slots, scratch);
+  }
+
+public:
+  typedef T value_type;
+  typedef const T *const_iterator; ///< iteratore ad accesso casuale, in ordine crescente
+
+  /**
+    @brief Costruttore da una lista letterale: ordina, elimina i duplicati e calcola l'hash perfetto
+
+    @param vals elementi del Set (anche ripetuti)
+  */
+  constexpr explicit StaticSet(const T (&vals)[N])
+      : _vals(), _size(0), _slots(), _disp(), _hashed(false), _less(), _hash()
+  {
+    // heap sort: std::sort non e' constexpr in C++17
+    for (std::size_t i = 0; i < N; ++i)
+      _vals[i] = vals[i];
+    for (std::size_t i = N / 2; i > 0; --i)
+      sift_down(i - 1, N);
+    for (std::size_t n = N - 1; n > 0; --n)
+    {
+      T tmp = _vals[0];
+      _vals[0] = _vals[n];
+      _vals[n] = tmp;
+      sift_down(0, n);
+    }
+
+    _size = 1;
+    for (std::size_t i = 1; i < N; ++i)
+      if (_less(_vals[_size - 1], _vals[i]))
+        _vals[_size++] = _vals[i];
+    for (std::size_t i = _size; i < N; ++i)
+      _vals[i] = T();
+
+    _hashed = build_hash();
+  }
+
+  /**
+    @brief Ricerca di un valore nel Set
+
+    @param val valore da cercare (di tipo qualsiasi confrontabile con T tramite Less e Hash)
+
+    @return true se un elemento equivalente a val e' presente nel Set, false altrimenti
+  */
+  template <typename K>
+  constexpr bool find(const K &val) const
+  {
+    return locate(val) != _size;
+  }
+
+  /**
+    @brief Sinonimo di find
+
+    @param val valore da cercare
+
+    @return true se val e' presente nel Set, false altrimenti
+  */
+  template <typename K>
+  constexpr bool contains(const K &val) const
+  {
+    return locate(val) != _size;
+  }
+
+  /**
+    @brief Posizione di un elemento nell'ordine del Set
+
+    @param val valore da cercare
+
+    @return indice di val, oppure size() se val non e' presente
+  */
+  template <typename K>
+  constexpr std::size_t index_of(const K &val) const
+  {
+    return locate(val);
+  }
+
+  /**
+    @brief Numero di elementi distinti
+
+    @return numero di elementi del Set
+  */
+  constexpr std::size_t size() const
+  {
+    return _size;
+  }
+
+  /**
+    @brief Indica se find usa la funzione hash perfetta
+
+    @return false se find usa la ricerca binaria (elementi con hash identico)
+  */
+  constexpr bool perfect_hash() const
+  {
+    return _hashed;
+  }
+
+  /**
+    @brief Operatore di lettura dell'elemento in posizione index (in ordine crescente)
+
+    @param index indice dell'elemento da leggere
+
+    @return reference all'elemento in posizione index
+
+    @throw myexcp::myexcp_out_of_range se viene passato un indice out of bounds
+  */
+  constexpr const T &operator[](std::size_t index) const
+  {
+    if (index >= _size)
+      SET_THROW(myexcp_out_of_range("Index out of bounds"));
+    return _vals[index];
+  }
+
+  constexpr const_iterator begin() const
+  {
+    return _vals;
+  }
+
+  constexpr const_iterator end() const
+  {
+    return _vals + _size;
+  }
+
+  /**
+    @brief Confronto tra StaticSet, anche costruiti da liste di lunghezza diversa
+
+    @param other StaticSet da confrontare
+
+    @return true se i due Set contengono gli stessi elementi
+  */
+  template <std::size_t M>
+  constexpr bool operator==(const StaticSet<T, M, Less, Hash> &other) const
+  {
+    if (_size != other.size())
+      return false;
+    for (std::size_t i = 0; i < _size; ++i)
+      if (_less(_vals[i], other[i]) || _less(other[i], _vals[i]))
+        return false;
+    return true;
+  }
+
+  /**
+    @brief Stampa del Set, nel formato di operator<< dei Set
+
+    @return ostream su cui e' stato scritto il Set
+  */
+  friend std::ostream &operator<<(std::ostream &os, const StaticSet &mset)
+  {
+    os << "{";
+    for (std::size_t i = 0; i < mset._size; ++i)
+    {
+      if (i != 0)
+        os << ", ";
+      os << mset._vals[i];
+    }
+    os << "}";
+    return os;
+  }
+};
+
+/**
+  @brief Crea uno StaticSet deducendo tipo e lunghezza della lista
+
+  @param vals elementi del Set (es. make_static_set({3, 1, 2}) o make_static_set<std::string_view>({"a", "b"}))
+
+  @return StaticSet ordinato e senza duplicati, utilizzabile in un'espressione costante
+*/
+template <typename T, std::size_t N>
+constexpr StaticSet<T, N> make_static_set(const T (&vals)[N])
+{
+  return StaticSet<T, N>(vals);
+}
+
+#endif
@@ -0,0 +1,677 @@
+#ifndef FLATSET_H
+#define FLATSET_H
+
+#include "set.h"
+
+#include <iostream>
+#include <iterator>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+/**
+  @brief classe Set (FlatStorage)
+
+  La classe implementa un Set di elementi generici T unici memorizzati in un std::vector ordinato
+  secondo il funtore Less. La ricerca e' binaria, operator[] e' O(1) e gli iteratori sono ad
+  accesso casuale. Ogni elemento occupa solo sizeof(T) byte contigui.
+
+  add inserisce l'elemento nella sua posizione (ricerca binaria e spostamento della coda del
+  vettore); per molti elementi insert ordina il blocco e lo fonde in una passata. I metodi const
+  non modificano il Set, quindi piu' thread possono leggerlo contemporaneamente; gli iteratori e i
+  riferimenti agli elementi non sono validi dopo una modifica.
+
+  Less deve essere un ordinamento stretto coerente con Equals: Equals(a, b) se e solo se
+  !Less(a, b) && !Less(b, a).
+*/
+template <typename T, typename Equals, typename Less>
+class Set<T, Equals, FlatStorage<Less> >
+{
+  typedef typename std::remove_cv<T>::type value_type;
+
+  /**
+    @brief ricerca di un valore nel vettore ordinato
+
+    @param val valore da cercare
+
+    @return posizione del primo elemento non minore di val
+  */
+  typename std::vector<value_type>::const_iterator lower_bound(const T &val) const
+  {
+    return std::lower_bound(_vals.begin(), _vals.end(), val, _less);
+  }
+
+  std::vector<value_type> _vals; ///< elementi ordinati secondo Less
+  Equals _equals;                ///< funtore per il confronto di eguaglianza tra dati T
+  Less _less;                    ///< funtore di ordinamento tra dati T
+
+  template <typename U, typename E, typename L, typename P>
+  friend Set<U, E, FlatStorage<L> > filter_out(const Set<U, E, FlatStorage<L> > &mset, P pred);
+
+  template <typename U, typename E, typename L>
+  friend Set<U, E, FlatStorage<L> > operator+(const Set<U, E, FlatStorage<L> > &set1, const Set<U, E, FlatStorage<L> > &set2);
+
+  template <typename U, typename E, typename L>
+  friend Set<U, E, FlatStorage<L> > operator-(const Set<U, E, FlatStorage<L> > &set1, const Set<U, E, FlatStorage<L> > &set2);
+
+public:
+  /**
+    @brief Costruttore di default.
+
+    @post Set vuoto
+  */
+  Set() {}
+
+  /**
+    @brief Copy constructor
+
+    @param other Set da copiare
+
+    @post Set chiamante contiene tutti e soli gli elementi di other.
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  Set(const Set &other) : _vals(other._vals) {}
+
+  /**
+    @brief Costruttore con coppia di iteratori generici
+
+    @param beg iteratore all'inizio della sequenza
+    @param end iteratore alla fine della sequenza
+
+    @post Set chiamante contiene tutti e soli gli elementi della sequenza tra beg e end
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Q>
+  Set(Q beg, Q end)
+  {
+    SET_TRY
+    {
+      insert(beg, end);
+    }
+    SET_CATCH_ALL
+    {
+      clear();
+      SET_ALLOC_ERROR();
+    }
+  }
+
+  /**
+    @brief Operatore di assegnamento
+
+    @param other Set da copiare
+
+    @return reference al Set this
+
+    @post Set chiamante contiene tutti e soli gli elementi di other.
+  */
+  Set &operator=(const Set &other)
+  {
+    if (this != &other)
+    {
+      Set tmp(other);
+      _vals.swap(tmp._vals);
+    }
+    return *this;
+  }
+
+  /**
+    @brief Distruttore
+  */
+  ~Set() {}
+
+  /**
+    @brief Svuota il Set
+
+    @post Set vuoto
+  */
+  void clear()
+  {
+    std::vector<value_type>().swap(_vals);
+  }
+
+  /**
+    @brief Numero di elementi nel Set
+
+    @return numero di elementi nel Set
+  */
+  unsigned int size() const
+  {
+    return static_cast<unsigned int>(_vals.size());
+  }
+
+  /**
+     @brief Operatore di lettura dell'elemento in posizione index (in ordine crescente)
+
+     @param index indice dell'elemento da leggere
+
+     @return reference all'elemento in posizione index
+
+     @throw myexcp::myexcp_domain_error se viene passato un Set vuoto
+     @throw myexcp::myexcp_out_of_range se viene passato un indice out of bounds
+   */
+  const T &operator[](int index) const
+  {
+    if (_vals.empty())
+      SET_THROW(myexcp_domain_error("Empty Set"));
+    if (index < 0 || static_cast<std::size_t>(index) > _vals.size() - 1)
+      SET_THROW(myexcp_out_of_range("Index out of bounds"));
+    return _vals[index];
+  }
+
+  /**
+    @brief Operatore di confronto (uguaglianza) tra due Set
+
+    @param other Set da confrontare
+
+    @return true se other e il Set chiamante contengono gli stessi elementi
+  */
+  bool operator==(const Set &other) const
+  {
+    if (_vals.size() != other._vals.size())
+      return false;
+    return std::equal(_vals.begin(), _vals.end(), other._vals.begin(), _equals);
+  }
+
+  /**
+    @brief Aggiunge un elemento nel set assicurandosi che non sia gia' presente
+
+    @param val valore da inserire nel set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void add(const T &val)
+  {
+    typename std::vector<value_type>::const_iterator it = lower_bound(val);
+    if (it != _vals.end() && _equals(*it, val))
+      return;
+    _vals.insert(_vals.begin() + (it - _vals.begin()), val);
+  }
+
+  /**
+    @brief Aggiunge al Set tutti gli elementi di una sequenza
+
+    La sequenza viene ordinata, privata dei duplicati e fusa con il vettore in O(k log k + n).
+
+    @param first iteratore all'inizio della sequenza
+    @param last iteratore alla fine della sequenza
+
+    @return numero di elementi effettivamente aggiunti
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Iter>
+  unsigned int insert(Iter first, Iter last)
+  {
+    std::vector<value_type> batch;
+    while (first != last)
+    {
+      batch.push_back(static_cast<T>(*first));
+      ++first;
+    }
+    std::stable_sort(batch.begin(), batch.end(), _less);
+    batch.erase(std::unique(batch.begin(), batch.end(), _equals), batch.end());
+
+    std::vector<value_type> out;
+    out.reserve(_vals.size() + batch.size());
+    std::set_union(_vals.begin(), _vals.end(), batch.begin(), batch.end(),
+                   std::back_inserter(out), _less);
+    unsigned int added = out.size() - _vals.size();
+    _vals.swap(out);
+    return added;
+  }
+
+  /**
+    @brief Prealloca lo spazio per n elementi
+
+    @param n numero di elementi che il Set deve poter contenere senza ulteriori allocazioni
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void reserve(unsigned int n)
+  {
+    _vals.reserve(n);
+  }
+
+  /**
+    @brief Rimuove (se presente) un elemento dal set.
+
+    @param val valore da rimuovere dal set
+
+    @return true se val e' stato rimosso, false altrimenti
+  */
+  bool remove(const T &val)
+  {
+    typename std::vector<value_type>::const_iterator it = lower_bound(val);
+    if (it != _vals.end() && _equals(*it, val))
+    {
+      _vals.erase(_vals.begin() + (it - _vals.begin()));
+      return true;
+    }
+    return false;
+  }
+
+  /**
+    @brief Rimuove tutti gli elementi che soddisfano un predicato
+
+    @param pred predicato booleano sui dati T
+
+    @return numero di elementi rimossi
+  */
+  template <typename P>
+  unsigned int remove_if(P pred)
+  {
+    std::size_t before = _vals.size();
+    _vals.erase(std::remove_if(_vals.begin(), _vals.end(), pred), _vals.end());
+    return before - _vals.size();
+  }
+
+  /**
+    @brief ricerca di un valore nel Set (ricerca binaria)
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool find(const T &val) const
+  {
+    typename std::vector<value_type>::const_iterator it = lower_bound(val);
+    return it != _vals.end() && _equals(*it, val);
+  }
+
+  /**
+    @brief Sinonimo di find
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool contains(const T &val) const
+  {
+    return find(val);
+  }
+
+  /**
+    @brief stampa del Set nello standard output
+
+    Overloading dell'operatore << dello standard output per stampa del Set
+
+    @return ostream con il Set da stampare
+  */
+  friend std::ostream &operator<<(std::ostream &os, const Set &mset)
+  {
+    os << "{";
+    for (std::size_t i = 0; i < mset._vals.size(); ++i)
+    {
+      if (i != 0)
+        os << ", ";
+      os << mset._vals[i];
+    }
+    os << "}";
+    return os;
+  }
+
+  /**
+  @brief classe const_iterator
+
+  Classe interna di iteratori costanti ad accesso casuale per iterare sul Set in ordine crescente
+
+  */
+  class const_iterator
+  {
+  public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T val_type;
+    typedef typename std::remove_cv<T>::type value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const T *pointer;
+    typedef const T &reference;
+
+    /**
+      @brief Costruttore di default.
+
+      @post _ptr = nullptr
+    */
+    const_iterator() : _ptr(nullptr), _end(nullptr) {}
+
+    /**
+      @brief Copy constructor
+
+      @param other iteratore da copiare
+    */
+    const_iterator(const const_iterator &other) : _ptr(other._ptr), _end(other._end) {}
+
+    /**
+      @brief Operatore di assegnamento
+
+      @param other iteratore da copiare
+
+      @return reference all'iteratore this
+    */
+    const_iterator &operator=(const const_iterator &other)
+    {
+      _ptr = other._ptr;
+      _end = other._end;
+      return *this;
+    }
+
+    /**
+      @brief Distruttore
+    */
+    ~const_iterator() {}
+
+    /**
+      @brief Operatore di dereferenziamento
+
+      @return reference al valore dell'elemento puntato
+
+      @throw myexcp::myexcp_domain_error se viene dereferenziato end()
+    */
+    reference operator*() const
+    {
+#if SET_ITERATOR_CHECKS
+      if (_ptr == _end)
+        SET_THROW(myexcp_domain_error("Dereferencing end()"));
+#endif
+      return *_ptr;
+    }
+
+    /**
+      @brief Operatore freccia
+
+      @return puntatore al valore dell'elemento puntato
+    */
+    pointer operator->() const
+    {
+      return &(operator*());
+    }
+
+    /**
+      @brief Operatore di accesso con offset
+
+      @param n distanza dall'elemento puntato
+
+      @return reference all'elemento a distanza n
+    */
+    reference operator[](difference_type n) const
+    {
+      return *(*this + n);
+    }
+
+    /**
+      @brief Operatore post incremento
+
+      @return copia dell'iteratore this (prima di essere incrementato)
+    */
+    const_iterator operator++(int)
+    {
+      const_iterator tmp(*this);
+      ++_ptr;
+      return tmp;
+    }
+
+    /**
+      @brief Operatore pre incremento
+
+      @return reference all'iteratore this (incrementato)
+    */
+    const_iterator &operator++()
+    {
+      ++_ptr;
+      return *this;
+    }
+
+    /**
+      @brief Operatore post decremento
+
+      @return copia dell'iteratore this (prima di essere decrementato)
+    */
+    const_iterator operator--(int)
+    {
+      const_iterator tmp(*this);
+      --_ptr;
+      return tmp;
+    }
+
+    /**
+      @brief Operatore pre decremento
+
+      @return reference all'iteratore this (decrementato)
+    */
+    const_iterator &operator--()
+    {
+      --_ptr;
+      return *this;
+    }
+
+    /**
+      @brief Avanza l'iteratore di n posizioni
+
+      @return reference all'iteratore this
+    */
+    const_iterator &operator+=(difference_type n)
+    {
+      _ptr += n;
+      return *this;
+    }
+
+    /**
+      @brief Arretra l'iteratore di n posizioni
+
+      @return reference all'iteratore this
+    */
+    const_iterator &operator-=(difference_type n)
+    {
+      _ptr -= n;
+      return *this;
+    }
+
+    /**
+      @brief Iteratore a distanza n
+
+      @return copia dell'iteratore spostata di n posizioni
+    */
+    const_iterator operator+(difference_type n) const
+    {
+      const_iterator tmp(*this);
+      return tmp += n;
+    }
+
+    /**
+      @brief Iteratore a distanza -n
+
+      @return copia dell'iteratore spostata di -n posizioni
+    */
+    const_iterator operator-(difference_type n) const
+    {
+      const_iterator tmp(*this);
+      return tmp -= n;
+    }
+
+    /**
+      @brief Iteratore a distanza n da it
+
+      @return copia di it spostata di n posizioni
+    */
+    friend const_iterator operator+(difference_type n, const const_iterator &it)
+    {
+      return it + n;
+    }
+
+    /**
+      @brief Distanza tra due iteratori
+
+      @return numero di posizioni tra other e this
+    */
+    difference_type operator-(const const_iterator &other) const
+    {
+      return _ptr - other._ptr;
+    }
+
+    /**
+    @brief Operatore di confronto (uguaglianza) tra due iteratori
+
+    @return true se i due iteratori puntano allo stesso elemento
+    */
+    bool operator==(const const_iterator &other) const
+    {
+      return _ptr == other._ptr;
+    }
+
+    /**
+    @brief Operatore di confronto (disuguaglianza) tra due iteratori
+
+    @return true se i due iteratori non puntano allo stesso elemento
+    */
+    bool operator!=(const const_iterator &other) const
+    {
+      return _ptr != other._ptr;
+    }
+
+    /**
+    @brief Operatori di ordinamento tra due iteratori
+
+    @return confronto tra le posizioni puntate
+    */
+    bool operator<(const const_iterator &other) const
+    {
+      return _ptr < other._ptr;
+    }
+
+    bool operator>(const const_iterator &other) const
+    {
+      return _ptr > other._ptr;
+    }
+
+    bool operator<=(const const_iterator &other) const
+    {
+      return _ptr <= other._ptr;
+    }
+
+    bool operator>=(const const_iterator &other) const
+    {
+      return _ptr >= other._ptr;
+    }
+
+  private:
+    const T *_ptr; ///< elemento puntato
+    const T *_end; ///< fine del Set, per il controllo del dereferenziamento
+
+    friend class Set;
+
+    const_iterator(const T *p, const T *e) : _ptr(p), _end(e) {}
+  };
+
+  /**
+      @brief Iteratore all'inizio del Set
+
+      @return copia dell'iteratore all'elemento minimo del Set
+  */
+  const_iterator begin() const
+  {
+    return const_iterator(_vals.data(), _vals.data() + _vals.size());
+  }
+
+  /**
+      @brief Iteratore alla fine del Set
+
+      @return copia dell'iteratore alla fine del Set
+  */
+  const_iterator end() const
+  {
+    return const_iterator(_vals.data() + _vals.size(), _vals.data() + _vals.size());
+  }
+};
+
+/**
+  @brief Set a vettore ordinato
+
+  Nome storico di Set<T, Equals, FlatStorage<Less> >.
+*/
+template <typename T, typename Equals, typename Less = std::less<typename std::remove_cv<T>::type> >
+using FlatSet = Set<T, Equals, FlatStorage<Less> >;
+
+/**
+    @brief Crea un nuovo Set con tutti e soli gli elementi del Set di partenza che soddisfano un certo predicato
+
+    @param mset Set di partenza
+    @param pred predicato booleano filtro
+
+    @return Set con tutti e soli gli elementi del Set di partenza che soddisfano il predicato P
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename L, typename P>
+Set<T, E, FlatStorage<L> > filter_out(const Set<T, E, FlatStorage<L> > &mset, P pred)
+{
+  Set<T, E, FlatStorage<L> > out_set;
+
+  SET_TRY
+  {
+    // gli elementi filtrati restano ordinati
+    std::copy_if(mset._vals.begin(), mset._vals.end(), std::back_inserter(out_set._vals), pred);
+  }
+  SET_CATCH_ALL
+  {
+    SET_ALLOC_ERROR();
+  }
+  return out_set;
+}
+
+/**
+    @brief Unione di due Set (fusione lineare dei vettori ordinati)
+
+    @param set1 primo Set da unire
+    @param set2 secondo Set da unire
+
+    @return Set che contiene gli elementi di entrambi i Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename L>
+Set<T, E, FlatStorage<L> > operator+(const Set<T, E, FlatStorage<L> > &set1, const Set<T, E, FlatStorage<L> > &set2)
+{
+  Set<T, E, FlatStorage<L> > out_set;
+
+  SET_TRY
+  {
+    out_set._vals.reserve(set1._vals.size() + set2._vals.size());
+    std::set_union(set1._vals.begin(), set1._vals.end(), set2._vals.begin(), set2._vals.end(),
+                   std::back_inserter(out_set._vals), out_set._less);
+  }
+  SET_CATCH_ALL
+  {
+    SET_ALLOC_ERROR();
+  }
+  return out_set;
+}
+
+/**
+    @brief Intersezione di due Set (fusione lineare dei vettori ordinati)
+
+    @param set1 primo Set da intersecare
+    @param set2 secondo Set da intersecare
+
+    @return Set che contiene gli elementi comuni ad entrambi i Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename L>
+Set<T, E, FlatStorage<L> > operator-(const Set<T, E, FlatStorage<L> > &set1, const Set<T, E, FlatStorage<L> > &set2)
+{
+  Set<T, E, FlatStorage<L> > out_set;
+
+  SET_TRY
+  {
+    std::set_intersection(set1._vals.begin(), set1._vals.end(), set2._vals.begin(), set2._vals.end(),
+                          std::back_inserter(out_set._vals), out_set._less);
+  }
+  SET_CATCH_ALL
+  {
+    SET_ALLOC_ERROR();
+  }
+  return out_set;
+}
+
+#endif
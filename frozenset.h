@@ -0,0 +1,459 @@
+#ifndef FROZENSET_H
+#define FROZENSET_H
+
+#include "set.h"
+#include "perfecthash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+  @brief Segno di un tipo aritmetico o del tipo sottostante di un enum
+*/
+template <typename V, bool = std::is_enum<V>::value>
+struct frozen_signed : std::is_signed<V>
+{
+};
+
+template <typename V>
+struct frozen_signed<V, true> : std::is_signed<typename std::underlying_type<V>::type>
+{
+};
+
+/**
+  @brief Scrittura e lettura binaria degli elementi di un FrozenSet
+
+  La versione generica copia i byte dell'elemento ed e' disponibile per i tipi aritmetici e gli
+  enum; il TAG scritto nell'header codifica categoria (intero, bool, virgola mobile, enum), segno
+  e dimensione, quindi un file di int non viene letto come float. std::string viene scritta come
+  lunghezza a 64 bit seguita dai caratteri. Gli altri tipi (es. struct di valori) devono
+  specializzare questa struttura con un TAG proprio, diverso da quelli degli altri formati.
+*/
+template <typename V>
+struct frozen_io
+{
+  static_assert(std::is_arithmetic<V>::value || std::is_enum<V>::value,
+                "frozen_io needs a specialization with its own TAG for this type");
+
+  static const std::uint32_t KIND = std::is_same<V, bool>::value       ? 4u
+                                    : std::is_enum<V>::value           ? 3u
+                                    : std::is_floating_point<V>::value ? 2u
+                                                                       : 1u; ///< 1 intero, 2 virgola mobile, 3 enum, 4 bool
+
+  /// categoria (bit 12-15), segno (bit 8) e dimensione (bit 0-7) degli elementi
+  static const std::uint32_t TAG = KIND << 12 | (frozen_signed<V>::value ? 1u : 0u) << 8 | sizeof(V);
+
+  static void write(std::ostream &os, const V &v)
+  {
+    os.write(reinterpret_cast<const char *>(&v), sizeof(V));
+  }
+
+  static bool read(std::istream &is, V &v)
+  {
+    return static_cast<bool>(is.read(reinterpret_cast<char *>(&v), sizeof(V)));
+  }
+};
+
+template <>
+struct frozen_io<std::string>
+{
+  static const std::uint32_t TAG = 0x80000000u; ///< stringhe a lunghezza variabile
+
+  static void write(std::ostream &os, const std::string &s)
+  {
+    std::uint64_t len = s.size();
+    os.write(reinterpret_cast<const char *>(&len), sizeof(len));
+    os.write(s.data(), s.size());
+  }
+
+  static bool read(std::istream &is, std::string &s)
+  {
+    std::uint64_t len = 0;
+    if (!is.read(reinterpret_cast<char *>(&len), sizeof(len)))
+      return false;
+    s.clear();
+    // lettura a blocchi: una lunghezza corrotta non provoca un'allocazione enorme
+    char buf[4096];
+    while (len != 0)
+    {
+      std::size_t chunk = len < sizeof(buf) ? static_cast<std::size_t>(len) : sizeof(buf);
+      if (!is.read(buf, chunk))
+        return false;
+      s.append(buf, chunk);
+      len -= chunk;
+    }
+    return true;
+  }
+};
+
+/**
+  @brief classe FrozenSet
+
+  Set immutabile costruito da un Set qualsiasi quando smette di cambiare (freeze). Calcola una
+  funzione hash perfetta minimale (perfect_hash, come StaticSet): gli n elementi sono divisi
+  in n bucket dall'hash e ad ogni bucket, dal piu' numeroso, viene assegnato il primo spostamento
+  che manda tutti i suoi elementi in posizioni libere di [0, n). L'elemento di posizione i e'
+  memorizzato in _vals[i], quindi find legge lo spostamento del bucket e confronta un solo
+  elemento, senza scansioni; lo spazio e' n * sizeof(T) piu' 4 byte per elemento e l'iterazione
+  scorre un vettore contiguo (in ordine di hash).
+
+  Il FrozenSet si puo' scrivere su file (write_frozen_set) e ricaricare senza ricalcolare la
+  funzione hash (read_frozen_set), ad esempio per costruirlo una volta e caricarlo da piu'
+  processi. Il formato binario usa l'ordine dei byte della macchina ed e' valido solo per
+  programmi con lo stesso Hash (ad esempio con la stessa libreria standard): read_frozen_set
+  verifica che ogni elemento letto sia nella posizione indicata dall'hash e rifiuta il file
+  altrimenti.
+
+  Il funtore Hash deve essere coerente con Equals: se Equals(a, b) allora Hash(a) == Hash(b).
+
+  @tparam T tipo degli elementi
+  @tparam Equals funtore di uguaglianza
+  @tparam Hash funtore di hash degli elementi
+*/
+template <typename T, typename Equals, typename Hash = set_hash>
+class FrozenSet
+{
+public:
+  typedef typename std::remove_cv<T>::type value_type;
+  typedef typename std::vector<value_type>::const_iterator const_iterator; ///< iteratore ad accesso casuale
+
+private:
+  static const std::uint32_t MAGIC = 0x54455346u; ///< "FSET" nell'ordine dei byte little endian
+  static const std::uint32_t VERSION = 1;         ///< versione del formato binario
+  static const unsigned int MAX_SEEDS = 16;       ///< semi provati prima di rinunciare
+
+  std::vector<value_type> _vals;    ///< elemento di posizione i in _vals[i]
+  std::vector<std::uint32_t> _disp; ///< spostamento di ogni bucket (tanti bucket quanti elementi)
+  std::uint64_t _seed;              ///< seme mescolato all'hash degli elementi
+  Equals _equals;                   ///< funtore di uguaglianza
+  Hash _hash;                       ///< funtore di hash
+
+  /**
+    @brief Hash dell'elemento mescolato con il seme corrente
+  */
+  template <typename K>
+  std::uint64_t mixed_hash(const K &key) const
+  {
+    return set_mix(static_cast<std::uint64_t>(_hash(key)) + _seed * 0x9e3779b97f4a7c15ull);
+  }
+
+  /**
+    @brief Posizione di un elemento secondo la funzione hash perfetta
+
+    @return posizione in [0, size()) (size() > 0)
+  */
+  template <typename K>
+  std::size_t position(const K &key) const
+  {
+    std::uint64_t h = mixed_hash(key);
+    return perfect_hash::slot(h, _disp[perfect_hash::bucket(h, _disp.size())], _disp.size());
+  }
+
+  /**
+    @brief Costruisce la funzione hash perfetta e dispone gli elementi
+
+    @param elems elementi distinti secondo Equals
+
+    @throw myexcp_domain_error se due elementi diversi hanno lo stesso hash
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void build(std::vector<value_type> &elems)
+  {
+    const std::size_t n = elems.size();
+    _vals.clear();
+    _disp.assign(n, 0);
+    if (n == 0)
+      return;
+
+    std::vector<std::uint64_t> hashes(n);
+    std::vector<std::uint32_t> owner(n);
+    std::vector<std::size_t> scratch(perfect_hash::scratch_size(n));
+    const std::uint32_t max_disp = n < (1u << 25) ? static_cast<std::uint32_t>(64 * n + 1024) : 0xffffffffu;
+    for (_seed = 0; _seed < MAX_SEEDS; ++_seed)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        hashes[i] = mixed_hash(elems[i]);
+      if (perfect_hash::place(hashes.data(), n, max_disp, _disp.data(), owner.data(), scratch.data()))
+        break;
+    }
+    if (_seed == MAX_SEEDS)
+    {
+      _disp.clear();
+      SET_THROW(myexcp_domain_error("FrozenSet: distinct elements with equal hash"));
+    }
+
+    _vals.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+      _vals.push_back(elems[owner[i]]);
+  }
+
+public:
+  /**
+    @brief Costruttore di default: FrozenSet vuoto (da riempire con read_frozen_set)
+  */
+  FrozenSet() : _seed(0) {}
+
+  /**
+    @brief Costruttore: congela gli elementi correnti di un Set
+
+    @param mset Set da congelare (con qualsiasi storage)
+    @param hash funtore di hash
+
+    @throw myexcp_domain_error se due elementi diversi hanno lo stesso hash
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename S>
+  explicit FrozenSet(const Set<T, Equals, S> &mset, Hash hash = Hash()) : _seed(0), _hash(hash)
+  {
+    std::vector<value_type> elems;
+    elems.reserve(mset.size());
+    for (typename Set<T, Equals, S>::const_iterator it = mset.begin(); it != mset.end(); ++it)
+      elems.push_back(*it);
+    build(elems);
+  }
+
+  /**
+    @brief Ricerca di un valore nel Set, con un solo confronto
+
+    @param val valore da cercare
+
+    @return true se val e' presente nel Set, false altrimenti
+  */
+  bool find(const T &val) const
+  {
+    return !_vals.empty() && _equals(_vals[position(val)], val);
+  }
+
+  /**
+    @brief Ricerca per chiavi di tipo qualsiasi (Equals e Hash trasparenti, es. string_hash)
+
+    @param key chiave da cercare
+
+    @return true se un elemento uguale a key e' presente nel Set, false altrimenti
+  */
+  template <typename K, typename E = Equals, typename H = Hash, typename = typename E::is_transparent,
+            typename = typename H::is_transparent>
+  bool find(const K &key) const
+  {
+    return !_vals.empty() && _equals(_vals[position(key)], key);
+  }
+
+  /**
+    @brief Sinonimo di find
+
+    @param val valore da cercare
+
+    @return true se val e' presente nel Set, false altrimenti
+  */
+  bool contains(const T &val) const
+  {
+    return find(val);
+  }
+
+  /**
+    @brief Posizione di un elemento (indice per operator[] e per dati paralleli dell'utente)
+
+    @param val valore da cercare
+
+    @return indice di val in [0, size()), oppure size() se val non e' presente
+  */
+  std::size_t index_of(const T &val) const
+  {
+    if (_vals.empty())
+      return 0;
+    std::size_t i = position(val);
+    return _equals(_vals[i], val) ? i : _vals.size();
+  }
+
+  /**
+    @brief Numero di elementi
+
+    @return numero di elementi del Set
+  */
+  unsigned int size() const
+  {
+    return static_cast<unsigned int>(_vals.size());
+  }
+
+  /**
+    @brief Operatore di lettura dell'elemento in posizione index (ordine di hash)
+
+    @param index indice dell'elemento da leggere
+
+    @return reference all'elemento in posizione index
+
+    @throw myexcp::myexcp_domain_error se viene passato un Set vuoto
+    @throw myexcp::myexcp_out_of_range se viene passato un indice out of bounds
+  */
+  const T &operator[](int index) const
+  {
+    if (_vals.empty())
+      SET_THROW(myexcp_domain_error("Empty Set"));
+    if (index < 0 || static_cast<std::size_t>(index) >= _vals.size())
+      SET_THROW(myexcp_out_of_range("Index out of bounds"));
+    return _vals[index];
+  }
+
+  const_iterator begin() const
+  {
+    return _vals.begin();
+  }
+
+  const_iterator end() const
+  {
+    return _vals.end();
+  }
+
+  /**
+    @brief Operatore di confronto (uguaglianza) tra due FrozenSet
+
+    @param other FrozenSet da confrontare
+
+    @return true se other e il Set chiamante contengono gli stessi elementi
+  */
+  bool operator==(const FrozenSet &other) const
+  {
+    if (_vals.size() != other._vals.size())
+      return false;
+    for (std::size_t i = 0; i < _vals.size(); ++i)
+      if (!other.find(_vals[i]))
+        return false;
+    return true;
+  }
+
+  /**
+    @brief Stampa del Set, nel formato di operator<< dei Set
+
+    @return ostream su cui e' stato scritto il Set
+  */
+  friend std::ostream &operator<<(std::ostream &os, const FrozenSet &mset)
+  {
+    os << "{";
+    for (std::size_t i = 0; i < mset._vals.size(); ++i)
+    {
+      if (i != 0)
+        os << ", ";
+      os << mset._vals[i];
+    }
+    os << "}";
+    return os;
+  }
+
+  /**
+    @brief Scrive un FrozenSet in formato binario
+
+    Formato: magic, versione, formato degli elementi (uint32), numero di elementi, seme
+    (uint64), spostamenti (uint32 per bucket), elementi in ordine di posizione (frozen_io).
+
+    @param os ostream binario su cui scrivere
+    @param mset FrozenSet da scrivere
+
+    @return true se la scrittura e' riuscita
+  */
+  friend bool write_frozen_set(std::ostream &os, const FrozenSet &mset)
+  {
+    typedef frozen_io<value_type> io;
+    const std::uint32_t header[3] = {MAGIC, VERSION, io::TAG};
+    const std::uint64_t counts[2] = {mset._vals.size(), mset._seed};
+    os.write(reinterpret_cast<const char *>(header), sizeof(header));
+    os.write(reinterpret_cast<const char *>(counts), sizeof(counts));
+    if (!mset._disp.empty())
+      os.write(reinterpret_cast<const char *>(mset._disp.data()), mset._disp.size() * sizeof(std::uint32_t));
+    for (std::size_t i = 0; i < mset._vals.size(); ++i)
+      io::write(os, mset._vals[i]);
+    return static_cast<bool>(os);
+  }
+
+  /**
+    @brief Legge un FrozenSet scritto da write_frozen_set, senza ricalcolare la funzione hash
+
+    Verifica che ogni elemento si trovi nella posizione indicata da Hash: un file prodotto con un
+    hash diverso, un altro formato o dati corrotti viene rifiutato.
+
+    @param is istream binario da cui leggere
+    @param mset FrozenSet in cui caricare gli elementi
+
+    @return true se e' stato letto un FrozenSet valido; altrimenti viene impostato failbit su is
+            e mset non viene modificato
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  friend bool read_frozen_set(std::istream &is, FrozenSet &mset)
+  {
+    typedef frozen_io<value_type> io;
+    std::uint32_t header[3] = {0, 0, 0};
+    std::uint64_t counts[2] = {0, 0};
+    if (!is.read(reinterpret_cast<char *>(header), sizeof(header)) ||
+        !is.read(reinterpret_cast<char *>(counts), sizeof(counts)) ||
+        header[0] != MAGIC || header[1] != VERSION || header[2] != io::TAG || counts[1] >= MAX_SEEDS)
+    {
+      is.setstate(std::ios::failbit);
+      return false;
+    }
+
+    FrozenSet tmp;
+    tmp._equals = mset._equals;
+    tmp._hash = mset._hash;
+    tmp._seed = counts[1];
+    std::uint64_t n = counts[0];
+    // lettura a blocchi: un numero di elementi corrotto non provoca un'allocazione enorme
+    const std::size_t BLOCK = 4096;
+    for (std::uint64_t done = 0; done < n;)
+    {
+      std::size_t chunk = n - done < BLOCK ? static_cast<std::size_t>(n - done) : BLOCK;
+      std::size_t old = tmp._disp.size();
+      tmp._disp.resize(old + chunk);
+      if (!is.read(reinterpret_cast<char *>(tmp._disp.data() + old), chunk * sizeof(std::uint32_t)))
+      {
+        is.setstate(std::ios::failbit);
+        return false;
+      }
+      done += chunk;
+    }
+    for (std::uint64_t i = 0; i < n; ++i)
+    {
+      value_type v;
+      if (!io::read(is, v))
+      {
+        is.setstate(std::ios::failbit);
+        return false;
+      }
+      tmp._vals.push_back(v);
+    }
+
+    for (std::size_t i = 0; i < tmp._vals.size(); ++i)
+      if (tmp.position(tmp._vals[i]) != i)
+      {
+        is.setstate(std::ios::failbit);
+        return false;
+      }
+
+    std::swap(mset._vals, tmp._vals);
+    std::swap(mset._disp, tmp._disp);
+    mset._seed = tmp._seed;
+    return true;
+  }
+};
+
+/**
+  @brief Congela un Set: crea un FrozenSet con gli stessi elementi
+
+  @param mset Set da congelare
+
+  @return FrozenSet con ricerca a un solo confronto (es. auto frozen = freeze(set);)
+
+  @throw myexcp_domain_error se due elementi diversi hanno lo stesso hash
+  @throw std::bad_alloc possibile eccezione di allocazione
+*/
+template <typename T, typename E, typename S>
+FrozenSet<T, E> freeze(const Set<T, E, S> &mset)
+{
+  return FrozenSet<T, E>(mset);
+}
+
+#endif
@@ -0,0 +1,838 @@
+#ifndef HASHEDSET_H
+#define HASHEDSET_H
+
+#include "set.h"
+#include "batch_table.h"
+
+#include <iostream>
+#include <iterator>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+  @brief classe Set (CachedHashStorage)
+
+  La classe implementa un Set di elementi generici T unici come lista concatenata in cui ogni nodo
+  conserva anche l'hash del proprio valore, calcolato una sola volta all'inserimento.
+  Durante la ricerca l'hash del valore cercato viene confrontato con quello dei nodi prima di
+  chiamare Equals: quasi tutti i confronti con elementi diversi costano un confronto tra interi.
+
+  E' pensata per elementi costosi da confrontare come le std::string.
+  Il funtore Hash deve essere coerente con Equals: se Equals(a, b) allora Hash(a) == Hash(b).
+*/
+template <typename T, typename Equals, typename Hash>
+class Set<T, Equals, CachedHashStorage<Hash> >
+{
+
+  /**
+    @brief Struttura node
+
+    Ogni nodo ha un valore (val), il suo hash (hash) e un puntatore al nodo successivo (next).
+  */
+  struct node
+  {
+    T val;
+    std::size_t hash;
+    node *next;
+
+    /**
+      @brief Costruttore secondario
+
+      @param v valore da copiare
+      @param h hash di v
+
+      @post val == v
+      @post hash == h
+      @post next = nullptr
+    */
+    node(const T &v, std::size_t h) : val(v), hash(h), next(nullptr) {}
+  };
+
+  /**
+    @brief ricerca di un valore nel Set
+
+    @param val valore da cercare nel Set
+    @param h hash di val
+    @param prev nodo precedente a quello trovato (nullptr se e' la testa)
+
+    @return puntatore al nodo con valore val, nullptr se non esiste
+  */
+  template <typename K>
+  node *find_internal(const K &val, std::size_t h, node *&prev) const
+  {
+    prev = nullptr;
+    node *curr = _head;
+
+    while (curr != nullptr)
+    {
+      if (curr->hash == h && _equals(curr->val, val))
+        return curr;
+      prev = curr;
+      curr = curr->next;
+    }
+    return nullptr;
+  }
+
+  /**
+    @brief ricerca di un valore (o di una chiave) nel Set di cui e' gia' noto l'hash
+
+    @param val valore da cercare nel Set
+    @param h hash di val
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  template <typename K>
+  bool find_hashed(const K &val, std::size_t h) const
+  {
+    node *prev;
+    return find_internal(val, h, prev) != nullptr;
+  }
+
+  /**
+    @brief Aggiunge un elemento di cui e' gia' noto l'hash
+
+    @param val valore da inserire nel set
+    @param h hash di val
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void add_hashed(const T &val, std::size_t h)
+  {
+    if (find_hashed(val, h))
+      return;
+
+    push_hashed(val, h);
+  }
+
+  /**
+    @brief Inserisce in testa un elemento che sicuramente non e' presente
+
+    @param val valore da inserire nel set
+    @param h hash di val
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void push_hashed(const T &val, std::size_t h)
+  {
+    node *tmp = new node(val, h);
+    tmp->next = _head;
+    _head = tmp;
+    ++_size;
+  }
+
+  /**
+    @brief Rimuove (se presente) l'elemento uguale a val
+
+    @param val valore (o chiave) da rimuovere, confrontato con Hash e Equals(T, K)
+
+    @return true se un elemento e' stato rimosso, false altrimenti
+  */
+  template <typename K>
+  bool remove_key(const K &val)
+  {
+    node *prev;
+    node *culprit = find_internal(val, _hash(val), prev);
+
+    if (culprit == nullptr)
+      return false;
+
+    if (prev == nullptr)
+      _head = culprit->next;
+    else
+      prev->next = culprit->next;
+    delete culprit;
+    culprit = nullptr; ///< per sicurezza
+    --_size;
+    return true;
+  }
+
+  node *_head;        ///< puntatore al primo elemento del Set
+  unsigned int _size; ///< numero di elementi nel Set
+  Equals _equals;     ///< funtore per il confronto di eguaglianza tra dati T
+  Hash _hash;         ///< funtore per il calcolo dell'hash dei dati T
+
+  template <typename U, typename E, typename H, typename P>
+  friend Set<U, E, CachedHashStorage<H> > filter_out(const Set<U, E, CachedHashStorage<H> > &mset, P pred);
+
+  template <typename U, typename E, typename H>
+  friend Set<U, E, CachedHashStorage<H> > operator+(const Set<U, E, CachedHashStorage<H> > &set1, const Set<U, E, CachedHashStorage<H> > &set2);
+
+  template <typename U, typename E, typename H>
+  friend Set<U, E, CachedHashStorage<H> > operator-(const Set<U, E, CachedHashStorage<H> > &set1, const Set<U, E, CachedHashStorage<H> > &set2);
+
+public:
+  /**
+    @brief Costruttore di default.
+
+    @post _head == nullptr
+    @post _size == 0
+  */
+  Set() : _head(nullptr), _size(0) {}
+
+  /**
+    @brief Copy constructor
+
+    Gli elementi (e i loro hash) vengono copiati nello stesso ordine, senza ricontrollare i duplicati.
+
+    @param other Set da copiare
+
+    @post _size = other._size
+    @post Set chiamante contiene tutti e soli gli elementi di other.
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  Set(const Set &other) : _head(nullptr), _size(0)
+  {
+    node *curr = other._head;
+    node **tail = &_head;
+
+    SET_TRY
+    {
+      while (curr != nullptr)
+      {
+        *tail = new node(curr->val, curr->hash);
+        tail = &((*tail)->next);
+        ++_size;
+        curr = curr->next;
+      }
+    }
+    SET_CATCH_ALL
+    {
+      clear();
+      SET_ALLOC_ERROR();
+    }
+  }
+
+  /**
+    @brief Costruttore con coppia di iteratori generici
+
+    @param beg iteratore all'inizio della sequenza
+    @param end iteratore alla fine della sequenza
+
+    @post Set chiamante contiene tutti e soli gli elementi della sequenza tra beg e end
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Q>
+  Set(Q beg, Q end) : _head(nullptr), _size(0)
+  {
+    SET_TRY
+    {
+      while (beg != end)
+      {
+        add(static_cast<T>(*beg));
+        ++beg;
+      }
+    }
+    SET_CATCH_ALL
+    {
+      clear();
+      SET_ALLOC_ERROR();
+    }
+  }
+
+  /**
+    @brief Operatore di assegnamento
+
+    @param other Set da copiare
+
+    @return reference al Set this
+
+    @post Set chiamante contiene tutti e soli gli elementi di other.
+  */
+  Set &operator=(const Set &other)
+  {
+    if (this != &other)
+    {
+      Set tmp(other);
+      std::swap(this->_head, tmp._head);
+      std::swap(this->_size, tmp._size);
+    }
+    return *this;
+  }
+
+  /**
+    @brief Distruttore
+
+    @post _head == nullptr
+    @post _size == 0
+  */
+  ~Set()
+  {
+    clear();
+  }
+
+  /**
+    @brief Svuota il Set
+
+    @post _head == nullptr
+    @post _size == 0
+  */
+  void clear()
+  {
+    node *curr = _head;
+
+    while (curr != nullptr)
+    {
+      node *next = curr->next;
+      delete curr;
+      curr = next;
+    }
+    _size = 0;
+    _head = nullptr;
+  }
+
+  /**
+    @brief Numero di elementi nel Set
+
+    @return numero di elementi nel Set
+  */
+  unsigned int size() const
+  {
+    return _size;
+  }
+
+  /**
+     @brief Operatore di lettura dell'elemento in posizione index
+
+     @param index indice dell'elemento da leggere
+
+     @return reference all'elemento in posizione index
+
+     @throw myexcp::myexcp_domain_error se viene passato un Set vuoto
+     @throw myexcp::myexcp_out_of_range se viene passato un indice out of bounds
+   */
+  const T &operator[](int index) const
+  {
+    if (_size == 0)
+      SET_THROW(myexcp_domain_error("Empty Set"));
+    if (index < 0 || static_cast<unsigned int>(index) > _size - 1)
+      SET_THROW(myexcp_out_of_range("Index out of bounds"));
+
+    node *curr = _head;
+    while (index != 0)
+    {
+      curr = curr->next;
+      --index;
+    }
+    return curr->val;
+  }
+
+  /**
+    @brief Operatore di confronto (uguaglianza) tra due Set
+
+    Due Set sono definiti equivalenti quando hanno esattamente gli stessi elementi,
+    a prescindere dal loro ordine. Gli hash gia' calcolati vengono riusati.
+
+    @param other Set da confrontare
+
+    @return true se other e il Set chiamante sono equivalenti
+  */
+  bool operator==(const Set &other) const
+  {
+    if (_size != other._size)
+      return false;
+    if (_head == other._head)
+      return true;
+
+    node *curr = _head;
+    while (curr != nullptr)
+    {
+      if (!other.find_hashed(curr->val, curr->hash))
+        return false;
+      curr = curr->next;
+    }
+    return true;
+  }
+
+  /**
+    @brief Aggiunge un elemento nel set assicurandosi che non sia gia' presente
+
+    @param val valore da inserire nel set
+
+    @post _size = _size+1 se val non era presente
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void add(const T &val)
+  {
+    add_hashed(val, _hash(val));
+  }
+
+  /**
+    @brief Rimuove (se presente) un elemento dal set.
+
+    @param val valore da rimuovere dal set
+
+    @post _size = _size-1 se val e' presente
+
+    @return true se val e' stato rimosso, false altrimenti
+  */
+  bool remove(const T &val)
+  {
+    return remove_key(val);
+  }
+
+  /**
+    @brief Rimuove (se presente) l'elemento uguale ad una chiave di tipo qualsiasi
+
+    Disponibile solo se Equals e Hash sono trasparenti (definiscono is_transparent):
+    la chiave non viene convertita in T.
+
+    @param key chiave da rimuovere dal set
+
+    @return true se un elemento e' stato rimosso, false altrimenti
+  */
+  template <typename K, typename E = Equals, typename H = Hash,
+            typename = typename E::is_transparent, typename = typename H::is_transparent>
+  bool remove(const K &key)
+  {
+    return remove_key(key);
+  }
+
+  /**
+    @brief ricerca di un valore nel Set
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool find(const T &val) const
+  {
+    if (_size == 0)
+      return false;
+    return find_hashed(val, _hash(val));
+  }
+
+  /**
+    @brief ricerca di una chiave di tipo qualsiasi nel Set
+
+    Disponibile solo se Equals e Hash sono trasparenti (definiscono is_transparent):
+    la chiave non viene convertita in T.
+
+    @param key chiave da cercare nel Set
+
+    @return true se un elemento uguale a key e' presente nel Set, false altrimenti
+  */
+  template <typename K, typename E = Equals, typename H = Hash,
+            typename = typename E::is_transparent, typename = typename H::is_transparent>
+  bool find(const K &key) const
+  {
+    if (_size == 0)
+      return false;
+    return find_hashed(key, _hash(key));
+  }
+
+  /**
+    @brief Sinonimo di find
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool contains(const T &val) const
+  {
+    return find(val);
+  }
+
+  /**
+    @brief Sinonimo di find per chiavi di tipo qualsiasi (Equals e Hash trasparenti)
+
+    @param key chiave da cercare nel Set
+
+    @return true se un elemento uguale a key e' presente nel Set, false altrimenti
+  */
+  template <typename K, typename E = Equals, typename H = Hash,
+            typename = typename E::is_transparent, typename = typename H::is_transparent>
+  bool contains(const K &key) const
+  {
+    return find(key);
+  }
+
+  /**
+    @brief ricerca di una sequenza di valori nel Set
+
+    Le chiavi cercate vengono inserite in una tabella hash; la lista viene percorsa una sola volta
+    confrontando l'hash memorizzato in ogni nodo con la tabella. Le celle della tabella relative ai
+    nodi successivi vengono precaricate (prefetch) mentre si controlla il nodo corrente.
+    Per ogni chiave della sequenza viene scritto in out un bool (true se presente nel Set).
+
+    @param first iteratore all'inizio della sequenza di chiavi
+    @param last iteratore alla fine della sequenza di chiavi
+    @param out iteratore di output su cui scrivere i risultati, nell'ordine della sequenza
+
+    @return numero di chiavi della sequenza presenti nel Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Iter, typename OutIter>
+  unsigned int find_many(Iter first, Iter last, OutIter out) const
+  {
+    typedef batch_table<T, Equals, Hash> table;
+
+    table batch(first, last, _hash);
+    const std::size_t k = batch.vals.size();
+    std::vector<std::size_t> rep;
+    std::vector<char> found(k, 0);
+    std::size_t missing = batch.insert_all(rep);
+
+    const node *ahead = _head;
+    for (std::size_t d = 0; d < table::PREFETCH_DISTANCE && ahead != nullptr; ++d)
+    {
+      __builtin_prefetch(batch.home(ahead->hash));
+      ahead = ahead->next;
+    }
+
+    for (const node *curr = _head; curr != nullptr && missing != 0; curr = curr->next)
+    {
+      if (ahead != nullptr)
+      {
+        __builtin_prefetch(batch.home(ahead->hash));
+        ahead = ahead->next;
+      }
+      std::size_t j = batch.find(curr->val, curr->hash);
+      if (j != k)
+      {
+        found[j] = 1;
+        --missing;
+      }
+    }
+
+    unsigned int hits = 0;
+    for (std::size_t i = 0; i < k; ++i)
+    {
+      bool f = found[rep[i]];
+      hits += f;
+      *out = f;
+      ++out;
+    }
+    return hits;
+  }
+
+  /**
+    @brief stampa del Set nello standard output
+
+    Overloading dell'operatore << dello standard output per stampa del Set
+
+    @return ostream con il Set da stampare
+  */
+  friend std::ostream &operator<<(std::ostream &os, const Set &mset)
+  {
+    node *curr = mset._head;
+    bool first = true;
+    os << "{";
+    while (curr != nullptr)
+    {
+      if (!first)
+        os << ", ";
+      first = false;
+      os << curr->val;
+      curr = curr->next;
+    }
+    os << "}";
+    return os;
+  }
+
+  /**
+  @brief classe const_iterator
+
+  Classe interna di iteratori costanti (sola lettura) per iterare sul Set
+
+  */
+  class const_iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T val_type;
+    typedef ptrdiff_t difference_type;
+    typedef const T *pointer;
+    typedef const T &reference;
+
+    /**
+      @brief Costruttore di default.
+
+      @post _ptr = nullptr
+    */
+    const_iterator() : _ptr(nullptr) {}
+
+    /**
+      @brief Copy constructor
+
+      @param other iteratore da copiare
+
+      @post _ptr = other._ptr
+    */
+    const_iterator(const const_iterator &other) : _ptr(other._ptr) {}
+
+    /**
+      @brief Operatore di assegnamento
+
+      @param other iteratore da copiare
+
+      @return reference all'iteratore this
+
+      @post _ptr = other._ptr
+    */
+    const_iterator &operator=(const const_iterator &other)
+    {
+      _ptr = other._ptr;
+      return *this;
+    }
+
+    /**
+      @brief Distruttore
+    */
+    ~const_iterator() {}
+
+    /**
+      @brief Operatore di dereferenziamento
+
+      @return reference al valore dell'elemento puntato da _ptr
+
+      @throw myexcp::myexcp_domain_error se viene dereferenziato un nullptr
+    */
+    reference operator*() const
+    {
+#if SET_ITERATOR_CHECKS
+      if (_ptr == nullptr)
+        SET_THROW(myexcp_domain_error("Dereferencing nullptr"));
+#endif
+      return _ptr->val;
+    }
+
+    /**
+      @brief Operatore freccia
+
+      @return puntatore al valore dell'elemento puntato da _ptr
+    */
+    pointer operator->() const
+    {
+#if SET_ITERATOR_CHECKS
+      if (_ptr == nullptr)
+        SET_THROW(myexcp_domain_error("Dereferencing nullptr"));
+#endif
+      return &(_ptr->val);
+    }
+
+    /**
+      @brief Operatore post incremento
+
+      @param int dummy parameter
+
+      @return reference all'iteratore this (prima di essere incrementato)
+
+      @throw myexcp::myexcp_domain_error se viene dereferenziato un nullptr
+    */
+    const_iterator operator++(int)
+    {
+#if SET_ITERATOR_CHECKS
+      if (_ptr == nullptr)
+        SET_THROW(myexcp_domain_error("Dereferencing nullptr"));
+#endif
+      const_iterator tmp(*this);
+      _ptr = _ptr->next;
+      return tmp;
+    }
+
+    /**
+      @brief Operatore pre incremento
+
+      @return reference all'iteratore this (incrementato)
+
+      @throw myexcp::myexcp_domain_error se viene dereferenziato un nullptr
+    */
+    const_iterator &operator++()
+    {
+#if SET_ITERATOR_CHECKS
+      if (_ptr == nullptr)
+        SET_THROW(myexcp_domain_error("Dereferencing nullptr"));
+#endif
+      _ptr = _ptr->next;
+      return *this;
+    }
+
+    /**
+    @brief Operatore di confronto (uguaglianza) tra due iteratori
+
+    @param other iteratore da confrontare
+
+    @return true se i due iteratori puntano allo stesso elemento
+    */
+    bool operator==(const const_iterator &other) const
+    {
+      return _ptr == other._ptr;
+    }
+
+    /**
+    @brief Operatore di confronto (disuguaglianza) tra due iteratori
+
+    @param other iteratore da confrontare
+
+    @return true se i due iteratori non puntano allo stesso elemento
+    */
+    bool operator!=(const const_iterator &other) const
+    {
+      return _ptr != other._ptr;
+    }
+
+  private:
+    const node *_ptr;
+
+    friend class Set;
+
+    const_iterator(const node *p) : _ptr(p) {}
+  };
+
+  /**
+      @brief Iteratore all'inizio del Set
+
+      @return copia dell'iteratore all'inizio del Set
+  */
+  const_iterator begin() const
+  {
+    return const_iterator(_head);
+  }
+
+  /**
+      @brief Iteratore alla fine del Set
+
+      @return copia dell'iteratore alla fine del Set
+  */
+  const_iterator end() const
+  {
+    return const_iterator(nullptr);
+  }
+};
+
+/**
+  @brief Funtore di hash trasparente per stringhe
+
+  Calcola lo stesso hash di std::hash<std::string> su qualunque valore convertibile in
+  std::string_view (std::string, const char*, std::string_view) senza allocare.
+*/
+struct string_hash
+{
+  typedef void is_transparent;
+
+  std::size_t operator()(std::string_view s) const
+  {
+    return std::hash<std::string_view>()(s);
+  }
+};
+
+/**
+  @brief Set a lista con hash memorizzato nei nodi
+
+  Nome storico di Set<T, Equals, CachedHashStorage<Hash> >.
+*/
+template <typename T, typename Equals, typename Hash = set_hash>
+using HashedSet = Set<T, Equals, CachedHashStorage<Hash> >;
+
+/**
+  @brief HashedSet di std::string
+
+  Set di stringhe con hash memorizzato nei nodi. Con un Equals trasparente find, remove e contains
+  accettano anche const char* e std::string_view senza costruire una std::string temporanea.
+*/
+template <typename Equals>
+using StringSet = HashedSet<std::string, Equals, string_hash>;
+
+/**
+    @brief Crea un nuovo Set con tutti e soli gli elementi del Set di partenza che soddisfano un certo predicato
+
+    Gli hash degli elementi copiati vengono riusati.
+
+    @param mset Set di partenza
+    @param pred predicato booleano filtro
+
+    @return Set con tutti e soli gli elementi del Set di partenza che soddisfano il predicato P
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename H, typename P>
+Set<T, E, CachedHashStorage<H> > filter_out(const Set<T, E, CachedHashStorage<H> > &mset, P pred)
+{
+  Set<T, E, CachedHashStorage<H> > out_set;
+  typename Set<T, E, CachedHashStorage<H> >::node *curr = mset._head;
+
+  SET_TRY
+  {
+    while (curr != nullptr)
+    {
+      if (pred(curr->val))
+        out_set.push_hashed(curr->val, curr->hash);
+      curr = curr->next;
+    }
+  }
+  SET_CATCH_ALL
+  {
+    SET_ALLOC_ERROR();
+  }
+  return out_set;
+}
+
+/**
+    @brief Concatenazione di due set
+
+    @param set1 primo Set da concatenare
+    @param set2 secondo Set da concatenare
+
+    @return Set che contiene gli elementi di entrambi i Set (la loro concatenazione)
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename H>
+Set<T, E, CachedHashStorage<H> > operator+(const Set<T, E, CachedHashStorage<H> > &set1, const Set<T, E, CachedHashStorage<H> > &set2)
+{
+  Set<T, E, CachedHashStorage<H> > out_set = set2;
+  typename Set<T, E, CachedHashStorage<H> >::node *curr = set1._head;
+
+  SET_TRY
+  {
+    while (curr != nullptr)
+    {
+      out_set.add_hashed(curr->val, curr->hash);
+      curr = curr->next;
+    }
+  }
+  SET_CATCH_ALL
+  {
+    SET_ALLOC_ERROR();
+  }
+  return out_set;
+}
+
+/**
+    @brief Intersezione di due Set
+
+    @param set1 primo Set da intersecare
+    @param set2 secondo Set da intersecare
+
+    @return Set che contiene gli elementi comuni ad entrambi i Set (la loro intersezione)
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename H>
+Set<T, E, CachedHashStorage<H> > operator-(const Set<T, E, CachedHashStorage<H> > &set1, const Set<T, E, CachedHashStorage<H> > &set2)
+{
+  Set<T, E, CachedHashStorage<H> > out_set;
+  typename Set<T, E, CachedHashStorage<H> >::node *curr = set1._head;
+
+  SET_TRY
+  {
+    while (curr != nullptr)
+    {
+      if (set2.find_hashed(curr->val, curr->hash))
+        out_set.push_hashed(curr->val, curr->hash);
+      curr = curr->next;
+    }
+  }
+  SET_CATCH_ALL
+  {
+    SET_ALLOC_ERROR();
+  }
+  return out_set;
+}
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include "set.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+  @brief classe HyperLogLog
+
+  Stima della cardinalita' di un insieme in memoria fissa: 2^p registri da un byte. L'hash di ogni
+  elemento sceglie un registro (p bit alti) e vi conserva la massima posizione del primo bit a 1
+  nei bit restanti. L'errore standard e' circa 1.04 / sqrt(2^p) (p = 14: 16 KiB, 0.8%).
+
+  Gli sketch con la stessa precisione si uniscono prendendo il massimo registro per registro
+  (merge, operator+): si stima cosi' |A + B + C ...| senza costruire l'unione dei Set. Come per
+  MinHash, un remove sul Set non si puo' annullare e lo sketch va ricostruito con assign.
+
+  @tparam Hash funtore di hash degli elementi
+*/
+template <typename Hash = set_hash>
+class HyperLogLog
+{
+  std::vector<unsigned char> _regs; ///< registri
+  unsigned int _p;                  ///< bit dell'hash usati per scegliere il registro
+  Hash _hash;                       ///< funtore di hash degli elementi
+
+public:
+  /**
+    @brief Costruttore: sketch dell'insieme vuoto
+
+    @param p precisione, tra 4 e 18 (2^p registri)
+
+    @throw myexcp_out_of_range se p e' fuori dall'intervallo ammesso
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  explicit HyperLogLog(unsigned int p = 14) : _p(p)
+  {
+    if (p < 4 || p > 18)
+      SET_THROW(myexcp_out_of_range("HyperLogLog precision out of range"));
+    _regs.assign(std::size_t(1) << p, 0);
+  }
+
+  /**
+    @brief Costruttore: sketch di un Set
+
+    @param mset Set di cui stimare la cardinalita'
+    @param p precisione, tra 4 e 18
+
+    @throw myexcp_out_of_range se p e' fuori dall'intervallo ammesso
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename T, typename E, typename S>
+  explicit HyperLogLog(const Set<T, E, S> &mset, unsigned int p = 14) : HyperLogLog(p)
+  {
+    assign(mset);
+  }
+
+  /**
+    @brief Ricostruisce lo sketch a partire da un Set (ad esempio dopo delle remove)
+
+    @param mset Set di cui stimare la cardinalita'
+  */
+  template <typename T, typename E, typename S>
+  void assign(const Set<T, E, S> &mset)
+  {
+    clear();
+    for (typename Set<T, E, S>::const_iterator it = mset.begin(); it != mset.end(); ++it)
+      add(*it);
+  }
+
+  /**
+    @brief Aggiorna lo sketch con un elemento aggiunto all'insieme
+
+    @param val elemento aggiunto
+  */
+  template <typename K>
+  void add(const K &val)
+  {
+    std::uint64_t h = set_mix(static_cast<std::uint64_t>(_hash(val)));
+    std::size_t reg = static_cast<std::size_t>(h >> (64 - _p));
+    std::uint64_t rest = h << _p;
+    unsigned char rank = 1;
+    while (rank <= 64 - _p && (rest & (1ull << 63)) == 0)
+    {
+      ++rank;
+      rest <<= 1;
+    }
+    if (rank > _regs[reg])
+      _regs[reg] = rank;
+  }
+
+  /**
+    @brief Unisce allo sketch quello di un altro insieme
+
+    @param other sketch dell'altro insieme (stessa precisione)
+
+    @post lo sketch e' quello dell'unione dei due insiemi
+
+    @throw myexcp_domain_error se le precisioni sono diverse
+  */
+  void merge(const HyperLogLog &other)
+  {
+    if (_p != other._p)
+      SET_THROW(myexcp_domain_error("Incompatible HyperLogLog sketches"));
+    for (std::size_t i = 0; i < _regs.size(); ++i)
+      if (other._regs[i] > _regs[i])
+        _regs[i] = other._regs[i];
+  }
+
+  /**
+    @brief Riporta lo sketch a quello dell'insieme vuoto
+  */
+  void clear()
+  {
+    for (std::size_t i = 0; i < _regs.size(); ++i)
+      _regs[i] = 0;
+  }
+
+  /**
+    @brief Stima della cardinalita'
+
+    Per stime piccole (fino a 2.5 * 2^p con registri ancora a zero) usa il linear counting.
+
+    @return numero stimato di elementi distinti
+  */
+  double estimate() const
+  {
+    const double m = double(_regs.size());
+    double alpha;
+    if (_regs.size() == 16)
+      alpha = 0.673;
+    else if (_regs.size() == 32)
+      alpha = 0.697;
+    else if (_regs.size() == 64)
+      alpha = 0.709;
+    else
+      alpha = 0.7213 / (1 + 1.079 / m);
+
+    double sum = 0;
+    std::size_t zeros = 0;
+    for (std::size_t i = 0; i < _regs.size(); ++i)
+    {
+      sum += std::ldexp(1.0, -int(_regs[i]));
+      zeros += (_regs[i] == 0);
+    }
+
+    double e = alpha * m * m / sum;
+    if (e <= 2.5 * m && zeros != 0)
+      e = m * std::log(m / zeros);
+    return e;
+  }
+
+  /**
+    @brief Precisione dello sketch
+
+    @return numero di bit usati per scegliere il registro
+  */
+  unsigned int precision() const
+  {
+    return _p;
+  }
+
+  /**
+    @brief Unione di due sketch
+
+    @param a primo sketch
+    @param b secondo sketch (stessa precisione)
+
+    @return sketch dell'unione dei due insiemi
+
+    @throw myexcp_domain_error se le precisioni sono diverse
+  */
+  friend HyperLogLog operator+(const HyperLogLog &a, const HyperLogLog &b)
+  {
+    HyperLogLog result(a);
+    result.merge(b);
+    return result;
+  }
+};
+
+/**
+  @brief Stima della cardinalita' dell'intersezione per inclusione-esclusione
+
+  |A - B| = |A| + |B| - |A + B|: l'errore assoluto e' quello delle tre stime, quindi la stima
+  relativa peggiora quando l'intersezione e' piccola rispetto ai due insiemi.
+
+  @param a sketch del primo insieme
+  @param b sketch del secondo insieme (stessa precisione)
+
+  @return numero stimato di elementi comuni (mai negativo)
+
+  @throw myexcp_domain_error se le precisioni sono diverse
+*/
+template <typename H>
+double hll_intersection(const HyperLogLog<H> &a, const HyperLogLog<H> &b)
+{
+  double e = a.estimate() + b.estimate() - (a + b).estimate();
+  return e > 0 ? e : 0;
+}
+
+#endif
@@ -1,8 +1,31 @@
 #include "set.h"
+#include "roaring.h"
+#include "hashedset.h"
+#include "flatset.h"
+#include "openhashset.h"
+#include "adaptiveset.h"
+#include "setio.h"
+#include "setparallel.h"
+#include "threadpool.h"
+#include "shardedset.h"
+#include "minhash.h"
+#include "hyperloglog.h"
+#include "setview.h"
+#include "setindex.h"
+#include "skiplistset.h"
+#include "constexprset.h"
+#include "frozenset.h"
 #include "myexcp.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
 /**
   @brief Funtore di uguaglianza tra interi
@@ -55,6 +78,8 @@ struct float_equal
 /**
   @brief Funtore di uguaglianza tra string
 
+  Trasparente: confronta anche string con const char* e std::string_view senza allocare.
+
   @param a prima string da confrontare
   @param b seconda string da confrontare
 
@@ -62,7 +87,9 @@ struct float_equal
 */
 struct string_equal
 {
-	inline bool operator()(std::string a, std::string b) const
+	typedef void is_transparent;
+
+	inline bool operator()(std::string_view a, std::string_view b) const
 	{
 		return a == b;
 	}
@@ -153,7 +180,7 @@ struct float_is_positive
 */
 struct string_is_short
 {
-	inline bool operator()(std::string a) const
+	inline bool operator()(const std::string &a) const
 	{
 		return (a.length() < 5);
 	}
@@ -197,6 +224,26 @@ struct person_equal
 	}
 };
 
+/**
+  @brief Proiezione di person sulla coppia (nome, cognome)
+
+  @param a person da proiettare
+
+  @return coppia (nome, cognome) di a
+*/
+struct person_name
+{
+	inline std::pair<std::string_view, std::string_view> operator()(const person &a) const
+	{
+		return std::make_pair(std::string_view(a.name), std::string_view(a.surname));
+	}
+};
+
+/**
+  @brief Funtore di uguaglianza tra person, trasparente rispetto alla coppia (nome, cognome)
+*/
+typedef projected_equal<person, person_equal, person_name> person_name_equal;
+
 /**
   @brief Funtore per controllare eta' di person
 
@@ -212,6 +259,36 @@ struct person_is_old
 	}
 };
 
+/**
+  @brief Proiezione di person sull'eta'
+
+  @param a person da proiettare
+
+  @return eta' di a
+*/
+struct person_age
+{
+	inline unsigned int operator()(const person &a) const
+	{
+		return a.age;
+	}
+};
+
+/**
+  @brief Proiezione di person sul cognome
+
+  @param a person da proiettare
+
+  @return cognome di a
+*/
+struct person_surname
+{
+	inline std::string_view operator()(const person &a) const
+	{
+		return std::string_view(a.surname);
+	}
+};
+
 /**
   @brief Funtore per controllare dimensione di Set di interi
 
@@ -235,6 +312,84 @@ struct set_is_large
 	}
 };
 
+/**
+  @brief Stringa la cui copia (costruttore o assegnamento) lancia un'eccezione a comando
+
+  countdown conta le copie rimaste prima dell'eccezione (0 = nessuna eccezione).
+*/
+struct copy_bomb
+{
+	std::string text;
+	static int countdown;
+
+	copy_bomb(const char *t) : text(t) {}
+
+	copy_bomb(const copy_bomb &other) : text(other.text)
+	{
+		if (countdown > 0 && --countdown == 0)
+			throw myexcp_domain_error("copy_bomb exploded");
+	}
+
+	copy_bomb &operator=(const copy_bomb &other)
+	{
+		if (countdown > 0 && --countdown == 0)
+			throw myexcp_domain_error("copy_bomb exploded");
+		text = other.text;
+		return *this;
+	}
+};
+
+int copy_bomb::countdown = 0;
+
+/**
+  @brief Funtore di uguaglianza tra copy_bomb
+*/
+struct copy_bomb_equal
+{
+	bool operator()(const copy_bomb &a, const copy_bomb &b) const
+	{
+		return a.text == b.text;
+	}
+};
+
+/**
+  @brief stampa di un copy_bomb nello standard output
+*/
+std::ostream &operator<<(std::ostream &os, const copy_bomb &c)
+{
+	return os << c.text;
+}
+
+/**
+  @brief ordinamento di copy_bomb per testo (per SkipListSet)
+*/
+bool operator<(const copy_bomb &a, const copy_bomb &b)
+{
+	return a.text < b.text;
+}
+
+/**
+  @brief Funtore predicato: copy_bomb con testo di almeno due caratteri (per filter_view)
+*/
+struct copy_bomb_is_long
+{
+	bool operator()(const copy_bomb &c) const
+	{
+		return c.text.size() > 1;
+	}
+};
+
+/**
+  @brief Funtore hash di copy_bomb (per filter_view)
+*/
+struct copy_bomb_hash
+{
+	std::size_t operator()(const copy_bomb &c) const
+	{
+		return std::hash<std::string>()(c.text);
+	}
+};
+
 /**
 	@brief stampa del dato person nello standard output
 
@@ -1680,6 +1835,1797 @@ void test_const_iterator()
 	std::cout << "\t(cip)->age = " << cip->age << std::endl;
 }
 
+/**
+	@brief test sul RoaringSet
+	Test dell'interfaccia della classe RoaringSet (bitmap compressa di interi) e dei suoi container
+  */
+void test_roaring_set()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test su RoaringSet di interi
+	std::cout << "\n\n--- TEST SU ROARING SET ---\n"
+			  << std::endl;
+
+	RoaringSet<int_equal> set1;
+
+	// Test add (iterazione in ordine crescente)
+	std::cout << "- add" << std::endl;
+
+	std::cout << "\t10 to " << set1 << " -> ";
+	set1.add(10);
+	std::cout << set1 << std::endl;
+
+	std::cout << "\t-10 to " << set1 << " -> ";
+	set1.add(-10);
+	std::cout << set1 << std::endl;
+
+	std::cout << "\t100000 to " << set1 << " -> ";
+	set1.add(100000);
+	std::cout << set1 << std::endl;
+
+	std::cout << "\t10 to " << set1 << " -> ";
+	set1.add(10);
+	std::cout << set1 << std::endl;
+
+	// Test remove
+	std::cout << "- remove" << std::endl;
+
+	std::cout << "\t-5 from " << set1 << " -> ";
+	bool temp = set1.remove(-5);
+	std::cout << set1 << " : " << (temp ? "true" : "false") << std::endl;
+
+	std::cout << "\t100000 from " << set1 << " -> ";
+	temp = set1.remove(100000);
+	std::cout << set1 << " : " << (temp ? "true" : "false") << std::endl;
+
+	// Test find e operator []
+	std::cout << "- find / operator []" << std::endl;
+
+	std::cout << "\t10 in " << set1 << " : " << ((set1.find(10)) ? "true" : "false") << std::endl;
+	std::cout << "\t11 in " << set1 << " : " << ((set1.find(11)) ? "true" : "false") << std::endl;
+	std::cout << "\tset1[1] = " << set1[1] << std::endl;
+	try
+	{
+		std::cout << "\tset1[2] = " << set1[2] << std::endl;
+	}
+	catch (myexcp_out_of_range &e)
+	{
+		std::cerr << e.what() << std::endl;
+	}
+
+	// Test container bitmap e run
+	std::cout << "- container bitmap / run" << std::endl;
+
+	RoaringSet<int_equal> dense;
+	for (int i = 0; i < 200000; ++i)
+		dense.add(i);
+	RoaringSet<int_equal> evens;
+	for (int i = 0; i < 200000; i += 2)
+		evens.add(i);
+	std::cout << "\tdense[150000] = " << dense[150000] << ", evens[50000] = " << evens[50000] << std::endl;
+	std::cout << "\tdense bytes = " << dense.bytes_used();
+	std::cout << ", run_optimize = " << dense.run_optimize();
+	std::cout << ", bytes = " << dense.bytes_used() << std::endl;
+	std::cout << "\t199999 in dense : " << (dense.find(199999) ? "true" : "false") << std::endl;
+
+	// Test operator + e operator - (OR / AND tra container)
+	std::cout << "- operator + / operator -" << std::endl;
+
+	RoaringSet<int_equal> uni = evens + dense;
+	RoaringSet<int_equal> inter = dense - evens;
+	std::cout << "\t(evens + dense) == dense : " << ((uni == dense) ? "true" : "false") << std::endl;
+	std::cout << "\t(dense - evens) == evens : " << ((inter == evens) ? "true" : "false") << std::endl;
+
+	RoaringSet<int_equal> set2(set1.begin(), set1.end());
+	set2.add(3);
+	set2.add(-10);
+	std::cout << '\t' << set1 << " + " << set2 << " = " << set1 + set2 << std::endl;
+	std::cout << '\t' << set1 << " - " << set2 << " = " << set1 - set2 << std::endl;
+
+	// Test filter_out
+	std::cout << "- filter_out (positive)" << std::endl;
+
+	int_is_positive is_pos_int;
+	std::cout << '\t' << set2 << " -> " << filter_out(set2, is_pos_int) << std::endl;
+
+	// Test rimozione fino a riconversione in array
+	std::cout << "- remove (bitmap -> array)" << std::endl;
+
+	for (int i = 0; i < 200000; ++i)
+		if (i % 1000 != 0)
+			evens.remove(i);
+	std::cout << "\tevens[199] = " << evens[199] << ", evens - dense == evens : "
+			  << (((evens - dense) == evens) ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test sullo StringSet
+	Test dell'interfaccia della classe HashedSet su dati di tipo string (hash memorizzato nei nodi)
+  */
+void test_hashed_set()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test su StringSet
+	std::cout << "\n\n--- TEST SU STRING SET (HASHED) ---\n"
+			  << std::endl;
+
+	StringSet<string_equal> sets1;
+
+	// Test add
+	std::cout << "- add" << std::endl;
+
+	std::cout << "\t\"dolor\" to " << sets1 << " -> ";
+	sets1.add("dolor");
+	std::cout << sets1 << std::endl;
+
+	std::cout << "\t\"Ipsum\" to " << sets1 << " -> ";
+	sets1.add("Ipsum");
+	std::cout << sets1 << std::endl;
+
+	std::cout << "\t\"Lorem\" to " << sets1 << " -> ";
+	sets1.add("Lorem");
+	std::cout << sets1 << std::endl;
+
+	std::cout << "\t\"Ipsum\" to " << sets1 << " -> ";
+	sets1.add("Ipsum");
+	std::cout << sets1 << std::endl;
+
+	// Test remove
+	std::cout << "- remove" << std::endl;
+
+	std::cout << "\t\"Lorem\" from " << sets1 << " -> ";
+	bool temp = sets1.remove("Lorem");
+	std::cout << sets1 << " : " << (temp ? "true" : "false") << std::endl;
+
+	std::cout << "\t\"amet\" from " << sets1 << " -> ";
+	temp = sets1.remove("amet");
+	std::cout << sets1 << " : " << (temp ? "true" : "false") << std::endl;
+
+	// Test copy constructor e operator ==
+	std::cout << "- copy constructor / operator ==" << std::endl;
+
+	StringSet<string_equal> sets2(sets1);
+	std::cout << "\tsets2 = " << sets2 << std::endl;
+	std::cout << '\t' << sets1 << " == " << sets2 << " : " << ((sets1 == sets2) ? "true" : "false") << std::endl;
+	sets2.add("sit");
+	std::cout << '\t' << sets1 << " == " << sets2 << " : " << ((sets1 == sets2) ? "true" : "false") << std::endl;
+
+	// Test filter_out, operator+, operator-
+	std::cout << "- filter_out (short) / operator + / operator -" << std::endl;
+
+	string_is_short is_short;
+	std::cout << '\t' << sets2 << " -> " << filter_out(sets2, is_short) << std::endl;
+	sets1.add("amet");
+	std::cout << '\t' << sets1 << " + " << sets2 << " = " << sets1 + sets2 << std::endl;
+	std::cout << '\t' << sets1 << " - " << sets2 << " = " << sets1 - sets2 << std::endl;
+
+	// Test find
+	std::cout << "- find " << std::endl;
+
+	std::cout << "\t\"sit\" in " << sets2 << " : " << ((sets2.find("sit")) ? "true" : "false") << std::endl;
+	std::cout << "\t\"Sit\" in " << sets2 << " : " << ((sets2.find("Sit")) ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test sulla ricerca eterogenea
+	Test di find, remove e contains con chiavi di tipo diverso da T (Equals e Hash trasparenti)
+  */
+void test_transparent_lookup()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test su ricerca con chiavi eterogenee
+	std::cout << "\n\n--- TEST SU RICERCA ETEROGENEA ---\n"
+			  << std::endl;
+
+	Set<std::string, string_equal> sets1;
+	sets1.add("Lorem");
+	sets1.add("Ipsum");
+	sets1.add("dolor");
+
+	// Test find / contains con const char* e std::string_view
+	std::cout << "- find / contains (const char*, string_view)" << std::endl;
+
+	std::string_view sv("Ipsum");
+	std::cout << "\t\"Lorem\" in " << sets1 << " : " << ((sets1.find("Lorem")) ? "true" : "false") << std::endl;
+	std::cout << "\tsv(\"Ipsum\") in " << sets1 << " : " << ((sets1.contains(sv)) ? "true" : "false") << std::endl;
+	std::cout << "\t\"sit\" in " << sets1 << " : " << ((sets1.contains("sit")) ? "true" : "false") << std::endl;
+
+	// Test remove con const char*
+	std::cout << "- remove (const char*)" << std::endl;
+
+	std::cout << "\t\"dolor\" from " << sets1 << " -> ";
+	bool temp = sets1.remove("dolor");
+	std::cout << sets1 << " : " << (temp ? "true" : "false") << std::endl;
+
+	// Test StringSet (Hash trasparente)
+	std::cout << "- StringSet find / remove (string_view)" << std::endl;
+
+	StringSet<string_equal> sets2(sets1.begin(), sets1.end());
+	std::cout << "\tsv(\"Ipsum\") in " << sets2 << " : " << ((sets2.find(sv)) ? "true" : "false") << std::endl;
+	std::cout << "\t\"Lorem\" from " << sets2 << " -> ";
+	temp = sets2.remove("Lorem");
+	std::cout << sets2 << " : " << (temp ? "true" : "false") << std::endl;
+
+	// Test proiezione su person
+	std::cout << "- Set<person> find per (nome, cognome)" << std::endl;
+
+	struct person p1 = {"Ada", "Adi", 87};
+	struct person p2 = {"Bea", "Beo", 25};
+	Set<person, person_name_equal> setp1;
+	setp1.add(p1);
+	setp1.add(p2);
+	std::string name("Bea");
+	std::cout << "\t(Bea, Beo) in " << setp1 << " : "
+			  << ((setp1.find(std::make_pair(std::string_view(name), std::string_view("Beo")))) ? "true" : "false") << std::endl;
+	std::cout << "\t(Ada, Beo) in " << setp1 << " : "
+			  << ((setp1.contains(std::make_pair(std::string_view("Ada"), std::string_view("Beo")))) ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test sull'inserimento a blocchi
+	Test di reserve e insert (deduplicazione in una passata, nodi allocati in un unico blocco)
+  */
+void test_batch_insert()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test su reserve e insert
+	std::cout << "\n\n--- TEST SU INSERIMENTO A BLOCCHI ---\n"
+			  << std::endl;
+
+	Set<int, int_equal> set1;
+	set1.add(3);
+	set1.add(7);
+
+	// Test insert (duplicati interni e rispetto al Set)
+	std::cout << "- insert" << std::endl;
+
+	int batch[] = {1, 7, 2, 1, 9, 3, 2};
+	std::cout << "\t{1, 7, 2, 1, 9, 3, 2} to " << set1 << " -> ";
+	unsigned int added = set1.insert(batch, batch + 7);
+	std::cout << set1 << " : " << added << std::endl;
+
+	// Test reserve e riuso dei nodi rimossi
+	std::cout << "- reserve / remove / add" << std::endl;
+
+	set1.reserve(10);
+	set1.remove(9);
+	set1.remove(3);
+	set1.add(4);
+	std::cout << "\tset1 = " << set1 << std::endl;
+	Set<int, int_equal> set2 = set1;
+	set2.add(5);
+	set1 = set2;
+	std::cout << "\tset1 = " << set1 << std::endl;
+
+	// Test insert su stringhe
+	std::cout << "- insert (string)" << std::endl;
+
+	std::vector<std::string> words;
+	words.push_back("Lorem");
+	words.push_back("Ipsum");
+	words.push_back("Lorem");
+	Set<std::string, string_equal> sets1;
+	sets1.add("Ipsum");
+	added = sets1.insert(words.begin(), words.end());
+	std::cout << "\tsets1 = " << sets1 << " : " << added << std::endl;
+
+	// Test insert di grandi dimensioni
+	std::cout << "- insert (100000 elementi)" << std::endl;
+
+	std::vector<int> big;
+	for (int i = 0; i < 100000; ++i)
+		big.push_back(i % 60000);
+	Set<int, int_equal> set3;
+	set3.insert(big.begin(), big.begin() + 50000);
+	added = set3.insert(big.begin(), big.end());
+	std::cout << "\tadded = " << added << ", set3[0] = " << set3[0] << ", 59999 in set3 : "
+			  << ((set3.find(59999)) ? "true" : "false") << std::endl;
+
+	// Test copia che lancia dentro un nodo preallocato: il nodo torna fra quelli liberi
+	// Test chiavi con i bit bassi tutti uguali: la tabella temporanea rimescola l'hash
+	std::cout << "- insert di 30000 chiavi i << 16" << std::endl;
+
+	std::vector<int> strided;
+	for (int i = 0; i < 30000; ++i)
+		strided.push_back(i << 16);
+	Set<int, int_equal> set5;
+	added = set5.insert(strided.begin(), strided.end());
+	unsigned int again = set5.insert(strided.begin(), strided.end());
+	std::cout << "\tsize = " << set5.size() << ", aggiunti = " << added << ", di nuovo = " << again
+			  << ", find(29999 << 16) : " << (set5.find(29999 << 16) ? "true" : "false") << std::endl;
+
+	std::cout << "- copia che lancia su nodo preallocato" << std::endl;
+
+	Set<copy_bomb, copy_bomb_equal> set4;
+	set4.reserve(4);
+	set4.add("a string long enough to be allocated on the heap");
+	copy_bomb::countdown = 1;
+	try
+	{
+		set4.add("another string long enough to be allocated on the heap");
+	}
+	catch (myexcp_domain_error &e)
+	{
+		std::cout << "\t" << e.what() << std::endl;
+	}
+	set4.add("b");
+	set4.add("c");
+	set4.add("d");
+	std::cout << "\tset4 = " << set4 << std::endl;
+}
+
+/**
+	@brief test sulla rimozione a blocchi
+	Test di remove_if e remove con coppia di iteratori (una sola passata sulla lista)
+  */
+void test_batch_remove()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test su remove_if e remove a blocchi
+	std::cout << "\n\n--- TEST SU RIMOZIONE A BLOCCHI ---\n"
+			  << std::endl;
+
+	Set<int, int_equal> set1;
+	set1.add(0);
+	set1.add(-5);
+	set1.add(7);
+	set1.add(12);
+	set1.add(-4);
+
+	// Test remove_if
+	std::cout << "- remove_if (positive)" << std::endl;
+
+	int_is_positive is_pos_int;
+	std::cout << '\t' << set1 << " -> ";
+	unsigned int removed = set1.remove_if(is_pos_int);
+	std::cout << set1 << " : " << removed << std::endl;
+
+	// Test remove con coppia di iteratori
+	std::cout << "- remove (sequenza)" << std::endl;
+
+	int keys[] = {-4, 3, -4, 0};
+	std::cout << "\t{-4, 3, -4, 0} from " << set1 << " -> ";
+	removed = set1.remove(keys, keys + 4);
+	std::cout << set1 << " : " << removed << std::endl;
+
+	// Test remove_if su person
+	std::cout << "- remove_if (person old)" << std::endl;
+
+	struct person p1 = {"Ada", "Adi", 87};
+	struct person p2 = {"Bea", "Beo", 25};
+	Set<person, person_equal> setp1;
+	setp1.add(p1);
+	setp1.add(p2);
+	person_is_old is_old;
+	std::cout << '\t' << setp1 << " -> ";
+	removed = setp1.remove_if(is_old);
+	std::cout << setp1 << " : " << removed << std::endl;
+
+	// Test remove di grandi dimensioni
+	std::cout << "- remove (30% di 100000 elementi)" << std::endl;
+
+	std::vector<int> big, expired;
+	for (int i = 0; i < 100000; ++i)
+	{
+		big.push_back(i);
+		if (i % 10 < 3)
+			expired.push_back(i);
+	}
+	Set<int, int_equal> set2;
+	set2.insert(big.begin(), big.end());
+	removed = set2.remove(expired.begin(), expired.end());
+	std::cout << "\tremoved = " << removed << ", 12 in set2 : " << ((set2.find(12)) ? "true" : "false")
+			  << ", 13 in set2 : " << ((set2.find(13)) ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test sulla ricerca a blocchi
+	Test di find_many (una sola passata sul Set per tutte le chiavi cercate)
+  */
+void test_find_many()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test su find_many
+	std::cout << "\n\n--- TEST SU RICERCA A BLOCCHI ---\n"
+			  << std::endl;
+
+	Set<int, int_equal> set1;
+	set1.add(0);
+	set1.add(-5);
+	set1.add(7);
+
+	// Test find_many su Set
+	std::cout << "- find_many" << std::endl;
+
+	int keys[] = {7, 1, -5, 7, 2};
+	std::vector<bool> res;
+	unsigned int hits = set1.find_many(keys, keys + 5, std::back_inserter(res));
+	std::cout << "\t{7, 1, -5, 7, 2} in " << set1 << " : {";
+	for (std::size_t i = 0; i < res.size(); ++i)
+		std::cout << (i ? ", " : "") << (res[i] ? "true" : "false");
+	std::cout << "} : " << hits << std::endl;
+
+	// Test find_many su StringSet (hash memorizzati e prefetch)
+	std::cout << "- find_many (StringSet)" << std::endl;
+
+	StringSet<string_equal> sets1;
+	sets1.add("Lorem");
+	sets1.add("Ipsum");
+	std::vector<std::string> words;
+	words.push_back("Ipsum");
+	words.push_back("dolor");
+	bool found[2];
+	hits = sets1.find_many(words.begin(), words.end(), found);
+	std::cout << "\t{Ipsum, dolor} in " << sets1 << " : {" << (found[0] ? "true" : "false") << ", "
+			  << (found[1] ? "true" : "false") << "} : " << hits << std::endl;
+
+	// Test find_many di grandi dimensioni
+	std::cout << "- find_many (10000 chiavi su 100000 elementi)" << std::endl;
+
+	std::vector<int> big, queries;
+	for (int i = 0; i < 100000; ++i)
+		big.push_back(i);
+	for (int i = 0; i < 10000; ++i)
+		queries.push_back(i * 20);
+	Set<int, int_equal> set2;
+	set2.insert(big.begin(), big.end());
+	res.clear();
+	hits = set2.find_many(queries.begin(), queries.end(), std::back_inserter(res));
+	std::cout << "\thits = " << hits << ", res[4999] = " << (res[4999] ? "true" : "false")
+			  << ", res[5000] = " << (res[5000] ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test sul FlatSet
+	Test dell'interfaccia della classe FlatSet (vettore ordinato)
+  */
+void test_flat_set()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test su FlatSet
+	std::cout << "\n\n--- TEST SU FLAT SET ---\n"
+			  << std::endl;
+
+	FlatSet<int, int_equal> set1;
+
+	// Test add
+	std::cout << "- add" << std::endl;
+
+	std::cout << "\t10 to " << set1 << " -> ";
+	set1.add(10);
+	std::cout << set1 << std::endl;
+
+	std::cout << "\t-10 to " << set1 << " -> ";
+	set1.add(-10);
+	std::cout << set1 << std::endl;
+
+	std::cout << "\t5 to " << set1 << " -> ";
+	set1.add(5);
+	std::cout << set1 << std::endl;
+
+	std::cout << "\t5 to " << set1 << " -> ";
+	set1.add(5);
+	std::cout << set1 << std::endl;
+
+	// Test remove
+	std::cout << "- remove" << std::endl;
+
+	std::cout << "\t-5 from " << set1 << " -> ";
+	bool temp = set1.remove(-5);
+	std::cout << set1 << " : " << (temp ? "true" : "false") << std::endl;
+
+	std::cout << "\t5 from " << set1 << " -> ";
+	temp = set1.remove(5);
+	std::cout << set1 << " : " << (temp ? "true" : "false") << std::endl;
+
+	// Test operator [] e iteratori ad accesso casuale
+	std::cout << "- operator [] / const_iterator ad accesso casuale" << std::endl;
+
+	int vals[] = {7, 23, -5, 0, 23};
+	FlatSet<int, int_equal> set2(vals, vals + 5);
+	FlatSet<int, int_equal>::const_iterator it = set2.begin();
+	std::cout << "\tset2 = " << set2 << ", set2[3] = " << set2[3] << ", it[2] = " << it[2]
+			  << ", end - begin = " << (set2.end() - set2.begin()) << std::endl;
+	std::cout << "\tlower_bound(6) = " << *std::lower_bound(set2.begin(), set2.end(), 6) << std::endl;
+
+	// Test operator ==, +, -, filter_out
+	std::cout << "- operator == / + / - / filter_out" << std::endl;
+
+	set1.add(0);
+	std::cout << '\t' << set1 << " == " << set2 << " : " << ((set1 == set2) ? "true" : "false") << std::endl;
+	std::cout << '\t' << set1 << " + " << set2 << " = " << set1 + set2 << std::endl;
+	std::cout << '\t' << set1 << " - " << set2 << " = " << set1 - set2 << std::endl;
+	int_is_positive is_pos_int;
+	std::cout << '\t' << set2 << " -> " << filter_out(set2, is_pos_int) << std::endl;
+
+	// Test add su molti elementi
+	std::cout << "- add (100000 elementi)" << std::endl;
+
+	FlatSet<int, int_equal> set3;
+	for (int i = 100000; i > 0; --i)
+		set3.add(i % 70000);
+	std::cout << "\tset3[0] = " << set3[0] << ", set3[69999] = " << set3[69999] << ", 123 in set3 : "
+			  << ((set3.find(123)) ? "true" : "false") << std::endl;
+
+	// Test FlatSet di string
+	std::cout << "- FlatSet<string>" << std::endl;
+
+	FlatSet<std::string, string_equal> sets1;
+	sets1.add("dolor");
+	sets1.add("Lorem");
+	sets1.add("Ipsum");
+	std::cout << "\tsets1 = " << sets1 << std::endl;
+}
+
+/**
+  @brief Esegue le stesse operazioni su un Set di interi con uno Storage qualsiasi
+
+  @param name nome dello storage da stampare
+*/
+template <typename Storage>
+void storage_policy_ops(const char *name)
+{
+	typedef Set<int, int_equal, Storage> int_set;
+
+	int vals[] = {8, -3, 15, 8, 0};
+	int_set set1(vals, vals + 5);
+	int_set set2;
+	set2.add(15);
+	set2.add(4);
+	set2.add(-3);
+	set2.remove(4);
+
+	int_set set3 = set1 - set2;
+	int_is_positive is_pos_int;
+	int_set set4 = set1 + set2;
+	int sum = 0;
+	unsigned int count = 0;
+	for (typename int_set::const_iterator it = set4.begin(); it != set4.end(); ++it, ++count)
+		sum += *it;
+
+	std::cout << '\t' << name << ": size(set1 + set2) = " << count
+			  << ", set1 - set2 contains 15 : " << (set3.contains(15) ? "true" : "false")
+			  << ", filter_out(set1) contains -3 : " << (filter_out(set1, is_pos_int).contains(-3) ? "true" : "false")
+			  << ", sum = " << sum << ", set2 == set2 - set1 : " << ((set2 == set2 - set1) ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test sulle politiche di memorizzazione
+	Test del parametro Storage di Set (OpenHashSet su dati int e string)
+  */
+void test_storage_policy()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sul parametro Storage di Set
+	std::cout << "\n\n--- TEST SU STORAGE POLICY ---\n"
+			  << std::endl;
+
+	// Stesse operazioni con ogni storage
+	std::cout << "- stesse operazioni, storage diversi" << std::endl;
+
+	storage_policy_ops<ListStorage>("ListStorage");
+	storage_policy_ops<CachedHashStorage<> >("CachedHashStorage");
+	storage_policy_ops<FlatStorage<> >("FlatStorage");
+	storage_policy_ops<HashStorage<> >("HashStorage");
+	storage_policy_ops<BitmapStorage>("BitmapStorage");
+	storage_policy_ops<SkipListStorage<> >("SkipListStorage");
+
+	// Test HashStorage (indirizzamento aperto)
+	std::cout << "- HashStorage" << std::endl;
+
+	OpenHashSet<int, int_equal> set1;
+	for (int i = 0; i < 1000; ++i)
+		set1.add(i);
+	unsigned int removed = set1.remove_if([](int v)
+										  { return v % 4 != 0; });
+	for (int i = 1000; i < 1500; ++i)
+		set1.add(i * 4);
+	std::cout << "\tremoved = " << removed << ", 400 in set1 : " << (set1.find(400) ? "true" : "false")
+			  << ", 401 in set1 : " << (set1.find(401) ? "true" : "false")
+			  << ", 5996 in set1 : " << (set1.find(5996) ? "true" : "false") << std::endl;
+
+	std::vector<int> queries;
+	for (int i = 0; i < 40; ++i)
+		queries.push_back(i * 150);
+	std::vector<bool> found;
+	unsigned int hits = set1.find_many(queries.begin(), queries.end(), std::back_inserter(found));
+	std::cout << "\tfind_many: " << hits << " / " << queries.size() << " hits, found[1] = "
+			  << (found[1] ? "true" : "false") << ", found[2] = " << (found[2] ? "true" : "false") << std::endl;
+
+	OpenHashSet<std::string, string_equal, string_hash> sets1;
+	sets1.add("Lorem");
+	sets1.add("Ipsum");
+	std::string_view key = "Ipsum";
+	std::cout << "\tsets1 contains string_view \"Ipsum\" : " << (sets1.contains(key) ? "true" : "false");
+	sets1.remove(key);
+	std::cout << ", after remove : " << sets1 << std::endl;
+
+	try
+	{
+		OpenHashSet<int, int_equal> empty;
+		std::cout << "\t*empty.begin() -> ";
+		std::cout << *empty.begin() << std::endl;
+	}
+	catch (const myexcp_domain_error &e)
+	{
+		std::cout << e.what() << std::endl;
+	}
+}
+
+/**
+	@brief test sul Set adattivo
+	Test del cambio di rappresentazione di AdaptiveSet al variare della dimensione e delle soglie
+  */
+void test_adaptive_set()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test su AdaptiveSet
+	std::cout << "\n\n--- TEST SU ADAPTIVE SET ---\n"
+			  << std::endl;
+
+	// Test crescita oltre grow_size
+	std::cout << "- add oltre grow_size" << std::endl;
+
+	AdaptiveSet<int, int_equal> set1;
+	std::cout << "\tgrow_size = " << set1.thresholds().grow_size << ", shrink_size = " << set1.thresholds().shrink_size
+			  << std::endl;
+	for (int i = 0; i < 32; ++i)
+		set1.add(i);
+	std::cout << "\t32 elementi : " << set1.representation() << std::endl;
+	set1.add(32);
+	set1.add(32);
+	std::cout << "\t33 elementi : " << set1.representation() << ", size = " << set1.size()
+			  << ", conversions = " << set1.conversions() << std::endl;
+
+	// Test ritorno alla lista sotto shrink_size
+	std::cout << "- remove sotto shrink_size" << std::endl;
+
+	for (int i = 0; i < 25; ++i)
+		set1.remove(i);
+	std::cout << "\t" << set1.size() << " elementi : " << set1.representation() << std::endl;
+	set1.remove(25);
+	std::cout << "\t" << set1.size() << " elementi : " << set1.representation() << ", set1 = " << set1
+			  << ", conversions = " << set1.conversions() << std::endl;
+
+	// Test conversione per numero di ricerche
+	std::cout << "- find oltre lookup_count" << std::endl;
+
+	adaptive_thresholds th;
+	th.lookup_count = 10;
+	th.lookup_min_size = 4;
+	AdaptiveSet<int, int_equal, FlatStorage<> > set2(th);
+	set2.add(4);
+	set2.add(-1);
+	set2.add(9);
+	set2.add(2);
+	unsigned int hits = 0;
+	for (int i = 0; i < 9; ++i)
+		hits += set2.find(i);
+	std::cout << "\t9 find : " << set2.representation() << ", hits = " << hits << std::endl;
+	set2.find(9);
+	std::cout << "\t10 find : " << set2.representation() << std::endl;
+	set2.optimize();
+	std::cout << "\toptimize : " << set2.representation() << ", set2 = " << set2 << std::endl;
+
+	// Le ricerche const non cambiano rappresentazione mentre il Set viene iterato
+	AdaptiveSet<int, int_equal, FlatStorage<> > set4(th);
+	for (int i = 0; i < 20; ++i)
+		set4.add(i);
+	std::cout << "	set4 - set4 = " << (set4 - set4) << ", set4 : " << set4.representation() << std::endl;
+	set4.remove(-5);
+	std::cout << "	remove(-5) -> set4 : " << set4.representation() << std::endl;
+
+	// Test confronto, operatori e iteratori tra rappresentazioni diverse
+	std::cout << "- operator == / + / - / const_iterator" << std::endl;
+
+	AdaptiveSet<int, int_equal, FlatStorage<> > set3(th);
+	set3.add(9);
+	set3.add(2);
+	set3.add(-1);
+	set3.add(4);
+	std::cout << '\t' << set3.representation() << " == " << set2.representation() << " : "
+			  << ((set3 == set2) ? "true" : "false") << std::endl;
+
+	int sum = 0;
+	for (AdaptiveSet<int, int_equal, FlatStorage<> >::const_iterator it = set2.begin(); it != set2.end(); ++it)
+		sum += *it;
+	std::cout << "\tsum(set2) = " << sum << ", set2 - set3 = " << (set2 - set3) << ", size(set2 + set3) = "
+			  << (set2 + set3).size() << std::endl;
+
+	th.grow_size = 3;
+	set3.set_thresholds(th);
+	std::cout << "\tgrow_size = 3 -> set3 : " << set3.representation() << std::endl;
+}
+
+/**
+	@brief test sulle politiche di riordino
+	Test di REORDER_NONE, REORDER_FRONT e REORDER_COUNT sul Set a lista (ordine dopo le ricerche e copie)
+  */
+void test_reorder_policy()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sulle politiche di riorganizzazione della lista
+	std::cout << "\n\n--- TEST SU REORDER POLICY ---\n"
+			  << std::endl;
+
+	int vals[] = {5, 4, 3, 2, 1};
+
+	// Test move-to-front
+	std::cout << "- REORDER_MOVE_TO_FRONT" << std::endl;
+
+	Set<int, int_equal> set1(vals, vals + 5);
+	set1.set_reorder(REORDER_MOVE_TO_FRONT);
+	std::cout << "\t" << set1 << " find(4) -> ";
+	set1.find_and_promote(4);
+	std::cout << set1 << ", add(2) -> ";
+	set1.add(2);
+	std::cout << set1 << ", find(7) -> ";
+	set1.find_and_promote(7);
+	std::cout << set1 << ", find(3) const -> ";
+	set1.find(3);
+	std::cout << set1 << ", set1 - set1 = " << (set1 - set1) << std::endl;
+
+	// Test transpose
+	std::cout << "- REORDER_TRANSPOSE" << std::endl;
+
+	Set<int, int_equal> set2(vals, vals + 5);
+	set2.set_reorder(REORDER_TRANSPOSE);
+	std::cout << "\t" << set2 << " find(4) -> ";
+	set2.find_and_promote(4);
+	std::cout << set2 << ", find(4) -> ";
+	set2.find_and_promote(4);
+	std::cout << set2 << ", find(4) -> ";
+	set2.find_and_promote(4);
+	std::cout << set2 << std::endl;
+
+	// Test count
+	std::cout << "- REORDER_COUNT" << std::endl;
+
+	Set<int, int_equal> set3(vals, vals + 5);
+	set3.set_reorder(REORDER_COUNT);
+	std::cout << "\t" << set3 << " find(3) -> ";
+	set3.find_and_promote(3);
+	std::cout << set3 << ", find(5) -> ";
+	set3.find_and_promote(5);
+	std::cout << set3 << ", find(5) -> ";
+	set3.find_and_promote(5);
+	std::cout << set3 << ", contains(5) -> ";
+	set3.contains(5);
+	std::cout << set3 << std::endl;
+
+	// Test copia e confronto
+	std::cout << "- copia e operator ==" << std::endl;
+
+	Set<int, int_equal> set4 = set3;
+	std::cout << "\tset4.reorder() == REORDER_COUNT : " << ((set4.reorder() == REORDER_COUNT) ? "true" : "false")
+			  << ", set1 == set3 : " << ((set1 == set3) ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test sui controlli degli iteratori
+	Test dei controlli su iteratori invalidati o di fine sequenza (secondo SET_ITERATOR_CHECKS)
+  */
+void test_iterator_checks()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sui controlli degli iteratori
+	std::cout << "\n\n--- TEST SU ITERATOR CHECKS ---\n"
+			  << std::endl;
+
+	std::cout << "- SET_ITERATOR_CHECKS = " << SET_ITERATOR_CHECKS << std::endl;
+
+#if SET_ITERATOR_CHECKS >= 2
+	int vals[] = {1, 2, 3};
+	Set<int, int_equal> set1(vals, vals + 3);
+
+	// Un add non invalida gli iteratori
+	Set<int, int_equal>::const_iterator it = set1.begin();
+	set1.add(4);
+	std::cout << "\tadd(4), *it = " << *it << std::endl;
+
+	// Una remove fallita non invalida gli iteratori
+	set1.remove(7);
+	std::cout << "\tremove(7), *it = " << *it << std::endl;
+
+	// Una remove riuscita invalida gli iteratori
+	std::cout << "\tremove(2), *it -> ";
+	set1.remove(2);
+	try
+	{
+		std::cout << *it << std::endl;
+	}
+	catch (myexcp_domain_error &e)
+	{
+		std::cout << e.what() << std::endl;
+	}
+
+	// Anche clear invalida gli iteratori
+	it = set1.begin();
+	set1.clear();
+	std::cout << "\tclear(), ++it -> ";
+	try
+	{
+		++it;
+		std::cout << "ok" << std::endl;
+	}
+	catch (myexcp_domain_error &e)
+	{
+		std::cout << e.what() << std::endl;
+	}
+#endif
+}
+
+/**
+	@brief test sulla rimozione tramite iteratore
+	Test di find_iter ed erase e dei controlli sull'iteratore passato
+  */
+void test_erase()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test su find_iter ed erase
+	std::cout << "\n\n--- TEST SU FIND_ITER / ERASE ---\n"
+			  << std::endl;
+
+	int vals[] = {1, 2, 3, 4, 5, 6, 7, 8};
+	Set<int, int_equal> set1(vals, vals + 8);
+
+	// Test find_iter + erase
+	std::cout << "- find_iter + erase" << std::endl;
+
+	Set<int, int_equal>::const_iterator it = set1.find_iter(5);
+	std::cout << "\t" << set1 << " find_iter(5) = " << *it << ", erase -> ";
+	it = set1.erase(it);
+	std::cout << set1 << ", next = " << *it << std::endl;
+	std::cout << "\tfind_iter(9) == end() : " << ((set1.find_iter(9) == set1.end()) ? "true" : "false") << std::endl;
+
+	// Test erase durante l'iterazione
+	std::cout << "- erase durante l'iterazione" << std::endl;
+
+	std::cout << "\t" << set1 << " erase pari -> ";
+	it = set1.begin();
+	while (it != set1.end())
+	{
+		if (*it % 2 == 0)
+			it = set1.erase(it);
+		else
+			++it;
+	}
+	std::cout << set1 << std::endl;
+
+	// Test erase dopo una modifica in testa alla lista
+	std::cout << "- erase dopo add in testa" << std::endl;
+
+	it = set1.begin();
+	set1.add(10);
+	std::cout << "\t" << set1 << " erase(" << *it << ") -> ";
+	set1.erase(it);
+	std::cout << set1 << std::endl;
+
+	// Test erase di end()
+	std::cout << "- erase(end())" << std::endl;
+
+	try
+	{
+		set1.erase(set1.end());
+	}
+	catch (myexcp_domain_error &e)
+	{
+		std::cout << '\t' << e.what() << std::endl;
+	}
+
+	// Test erase con l'iteratore di un altro Set (controllato a ogni SET_ITERATOR_CHECKS)
+	std::cout << "- erase con un iteratore di un altro Set" << std::endl;
+
+	Set<int, int_equal> set2(vals, vals + 3);
+	try
+	{
+		set1.erase(set2.find_iter(2));
+	}
+	catch (myexcp_domain_error &e)
+	{
+		std::cout << '\t' << e.what() << ", set1 = " << set1 << ", set2 = " << set2 << std::endl;
+	}
+}
+
+/**
+	@brief test sull'interfaccia senza eccezioni
+	Test di try_add, try_at e contains, che segnalano l'errore senza lanciare eccezioni
+  */
+void test_try_api()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sulle varianti senza eccezioni
+	std::cout << "\n\n--- TEST SU API SENZA ECCEZIONI ---\n"
+			  << std::endl;
+
+	std::cout << "- SET_EXCEPTIONS = " << SET_EXCEPTIONS << std::endl;
+
+	Set<int, int_equal> set1;
+
+	// Test try_add
+	std::cout << "- try_add" << std::endl;
+
+	std::cout << "\t10 to " << set1 << " -> ";
+	set_status st = set1.try_add(10);
+	std::cout << set1 << " : " << ((st == SET_OK) ? "SET_OK" : "?") << std::endl;
+
+	std::cout << "\t10 to " << set1 << " -> ";
+	st = set1.try_add(10);
+	std::cout << set1 << " : " << ((st == SET_EXISTS) ? "SET_EXISTS" : "?") << std::endl;
+
+	set1.reserve(4);
+	std::cout << "\t-3 to " << set1 << " (nodi preallocati) -> ";
+	st = set1.try_add(-3);
+	std::cout << set1 << " : " << ((st == SET_OK) ? "SET_OK" : "?") << std::endl;
+
+	// Test try_at
+	std::cout << "- try_at" << std::endl;
+
+	const int *p = set1.try_at(1);
+	std::cout << "\t" << set1 << ".try_at(1) = " << ((p != nullptr) ? *p : 0);
+	std::cout << ", try_at(2) == nullptr : " << ((set1.try_at(2) == nullptr) ? "true" : "false");
+	std::cout << ", try_at(-1) == nullptr : " << ((set1.try_at(-1) == nullptr) ? "true" : "false") << std::endl;
+
+	Set<int, int_equal> empty;
+	std::cout << "\t{}.try_at(0) == nullptr : " << ((empty.try_at(0) == nullptr) ? "true" : "false")
+			  << ", {}.contains(0) : " << (empty.contains(0) ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test su lettura e scrittura testuale
+	Test di write_set e read_set (operator<< e operator>>) su input validi, errati e incompleti
+  */
+void test_text_io()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test su write_set / read_set / operator >>
+	std::cout << "\n\n--- TEST SU TEXT I/O ---\n"
+			  << std::endl;
+
+	// Test write_set (stesso formato di operator <<)
+	std::cout << "- write_set" << std::endl;
+
+	int vals[] = {-7, 0, 42, 2147483647};
+	Set<int, int_equal> set1(vals, vals + 4);
+	std::ostringstream out1, out2;
+	write_set(out1, set1);
+	out2 << set1;
+	std::cout << "\t" << out1.str() << " == operator<< : " << ((out1.str() == out2.str()) ? "true" : "false") << std::endl;
+
+	// Test operator >>
+	std::cout << "- operator >>" << std::endl;
+
+	std::istringstream in1("  {3,  -1 ,3, 12}  {}  tail");
+	Set<int, int_equal> set2, set3;
+	std::string rest;
+	in1 >> set2 >> set3 >> rest;
+	std::cout << "\tset2 = " << set2 << ", set3 = " << set3 << ", rest = " << rest << std::endl;
+
+	std::istringstream in2("{1, 2, x, 4}");
+	in2 >> set2;
+	std::cout << "\t\"{1, 2, x, 4}\" -> fail : " << (in2.fail() ? "true" : "false") << ", letti " << set2 << std::endl;
+
+	std::istringstream in3("{1, 2");
+	in3 >> set2;
+	std::cout << "\t\"{1, 2\" -> fail : " << (in3.fail() ? "true" : "false") << std::endl;
+
+	// Test round trip con input unico su molti elementi
+	std::cout << "- round trip (100000 elementi, unique)" << std::endl;
+
+	std::vector<int> many;
+	for (int i = 0; i < 100000; ++i)
+		many.push_back(i * 7 - 350000);
+	Set<int, int_equal> set4;
+	set4.insert(many.begin(), many.end());
+	std::stringstream io;
+	write_set(io, set4);
+	Set<int, int_equal> set5;
+	bool ok = read_set(io, set5, true);
+	std::cout << "\tok : " << (ok ? "true" : "false") << ", size = " << set5.size() << ", set5[0] = " << set5[0]
+			  << ", 349993 in set5 : " << (set5.find(349993) ? "true" : "false") << std::endl;
+
+	// Test su altri tipi e storage
+	std::cout << "- float / string / FlatSet" << std::endl;
+
+	float fvals[] = {0.1f, -2.5f};
+	FlatSet<float, float_equal> fset1(fvals, fvals + 2), fset2;
+	std::stringstream fio;
+	write_set(fio, fset1);
+	fio >> fset2;
+	std::cout << "\t" << fio.str() << " -> " << fset2 << ", == : " << ((fset1 == fset2) ? "true" : "false") << std::endl;
+
+	std::istringstream sin("{Lorem ipsum, dolor}");
+	Set<std::string, string_equal> sset;
+	sin >> sset;
+	std::cout << "\t" << sset << ", contains \"Lorem ipsum\" : " << (sset.contains("Lorem ipsum") ? "true" : "false")
+			  << std::endl;
+
+	std::ostringstream sout1, sout2;
+	write_set(sout1, sset);
+	sout2 << sset;
+	std::cout << "\twrite_set(sset) == operator<< : " << ((sout1.str() == sout2.str()) ? "true" : "false") << std::endl;
+
+	// la stringa vuota viene scritta come elemento vuoto e riletta
+	sset.add("");
+	std::stringstream eio;
+	eio << sset;
+	Set<std::string, string_equal> sset2;
+	eio >> sset2;
+	std::istringstream ein("{1, , 2}");
+	Set<int, int_equal> eset;
+	ein >> eset;
+	std::cout << "\t" << eio.str() << " -> size " << sset2.size() << ", contains \"\" : "
+			  << (sset2.contains("") ? "true" : "false") << ", == : " << ((sset == sset2) ? "true" : "false")
+			  << "; {1, , 2} in Set<int> fallisce : " << (ein.fail() ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test sulle operazioni insiemistiche parallele
+	Test di parallel_union, parallel_intersection, parallel_difference e parallel_equal confrontate con le versioni seriali
+  */
+void test_parallel_algebra()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sulle operazioni parallele
+	std::cout << "\n\n--- TEST SU PARALLEL ALGEBRA ---\n"
+			  << std::endl;
+
+	// Sotto soglia: stessi risultati delle operazioni seriali
+	std::cout << "- sotto soglia (seriale)" << std::endl;
+
+	int vals1[] = {1, 2, 3, 4};
+	int vals2[] = {3, 4, 5};
+	Set<int, int_equal> set1(vals1, vals1 + 4), set2(vals2, vals2 + 3);
+	std::cout << "\t" << set1 << " + " << set2 << " = " << parallel_union(set1, set2) << std::endl;
+	std::cout << "\t" << set1 << " - " << set2 << " = " << parallel_intersection(set1, set2) << std::endl;
+	std::cout << "\t" << set1 << " \\ " << set2 << " = " << parallel_difference(set1, set2) << std::endl;
+	std::cout << "\t" << set1 << " == " << set2 << " : " << (parallel_equal(set1, set2) ? "true" : "false") << std::endl;
+
+	// Sopra soglia: multipli di 2 e di 3 in [0, 300000)
+	std::cout << "- sopra soglia (4 thread)" << std::endl;
+
+	std::vector<int> even, triple;
+	for (int i = 0; i < 300000; i += 2)
+		even.push_back(i);
+	for (int i = 0; i < 300000; i += 3)
+		triple.push_back(i);
+	Set<int, int_equal> set3, set4;
+	set3.insert(even.begin(), even.end());
+	set4.insert(triple.begin(), triple.end());
+
+	parallel_policy pol;
+	pol.threads = 4;
+	Set<int, int_equal> uni = parallel_union(set3, set4, pol);
+	Set<int, int_equal> inter = parallel_intersection(set3, set4, pol);
+	Set<int, int_equal> diff = parallel_difference(set3, set4, pol);
+	std::cout << "\tsize(set3 + set4) = " << uni.size() << ", size(set3 - set4) = " << inter.size()
+			  << ", size(set3 \\ set4) = " << diff.size() << std::endl;
+	std::cout << "\t9 in unione : " << (uni.find(9) ? "true" : "false") << ", 12 in intersezione : "
+			  << (inter.find(12) ? "true" : "false") << ", 6 in differenza : " << (diff.find(6) ? "true" : "false")
+			  << std::endl;
+
+	Set<int, int_equal> set5;
+	set5.insert(even.rbegin(), even.rend());
+	std::cout << "\tset3 == set5 : " << (parallel_equal(set3, set5, pol) ? "true" : "false");
+	set5.remove(0);
+	set5.add(1);
+	std::cout << ", dopo remove(0) / add(1) : " << (parallel_equal(set3, set5, pol) ? "true" : "false") << std::endl;
+
+	// Altro storage
+	OpenHashSet<int, int_equal> hset1(even.begin(), even.end()), hset2(triple.begin(), triple.end());
+	std::cout << "\tOpenHashSet: size(unione) = " << parallel_union(hset1, hset2, pol).size() << std::endl;
+	FlatSet<int, int_equal> fset1(even.begin(), even.end()), fset2(triple.begin(), triple.end());
+	FlatSet<int, int_equal> funi = parallel_union(fset1, fset2, pol);
+	std::cout << "\tFlatSet: size(unione) = " << funi.size() << ", == seriale : "
+			  << ((funi == fset1 + fset2) ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test sul thread pool con work stealing
+	Test dell'esecuzione di task, dell'attesa e della propagazione delle eccezioni del thread pool
+  */
+void test_work_stealing()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sul pool di thread con furto di task
+	std::cout << "\n\n--- TEST SU WORK STEALING ---\n"
+			  << std::endl;
+
+	work_stealing_pool pool(4);
+	std::cout << "- pool con " << pool.threads() << " thread" << std::endl;
+
+	// 48 Set di dimensioni molto diverse (2000 o 50 elementi): il carico tra i task non e' uniforme
+	std::vector<Set<int, int_equal>> sets(48);
+	for (int k = 0; k < 48; ++k)
+	{
+		std::vector<int> vals;
+		for (int i = 0; i < (k % 8 == 0 ? 2000 : 50); ++i)
+			vals.push_back(i * (k % 4 + 1));
+		sets[k].insert(vals.begin(), vals.end());
+	}
+
+	std::cout << "- filter_out (positivi) su 48 Set" << std::endl;
+	std::vector<Set<int, int_equal>> filtered = pool_filter(pool, sets.begin(), sets.end(), int_is_positive());
+	std::cout << "\tsize(filtered[0]) = " << filtered[0].size() << ", size(filtered[1]) = " << filtered[1].size()
+			  << ", size(filtered[2]) = " << filtered[2].size() << std::endl;
+
+	std::cout << "- unioni e intersezioni di coppie consecutive" << std::endl;
+	std::vector<std::pair<const Set<int, int_equal> *, const Set<int, int_equal> *>> pairs;
+	for (int k = 0; k + 1 < 48; k += 2)
+		pairs.push_back(std::make_pair(&sets[k], &sets[k + 1]));
+	std::vector<Set<int, int_equal>> unions = pool_union(pool, pairs.begin(), pairs.end());
+	std::vector<Set<int, int_equal>> inters = pool_intersection(pool, pairs.begin(), pairs.end());
+	std::cout << "\t" << unions.size() << " unioni, size(unions[0]) = " << unions[0].size()
+			  << ", size(inters[0]) = " << inters[0].size() << std::endl;
+
+	std::cout << "- uguaglianza di tutte le coppie" << std::endl;
+	std::vector<char> equal = pool_equal_pairs(pool, sets.begin(), sets.end());
+	int count = 0;
+	for (std::size_t i = 0; i < equal.size(); ++i)
+		count += equal[i];
+	std::cout << "\tcoppie uguali (con se stessi) = " << count << ", sets[1] == sets[5] : "
+			  << (equal[1 * 48 + 5] ? "true" : "false") << ", sets[1] == sets[2] : "
+			  << (equal[1 * 48 + 2] ? "true" : "false") << std::endl;
+
+	// Risultati bool: ogni task scrive un elemento distinto (niente std::vector<bool> condiviso)
+	std::vector<int> nums;
+	for (int i = 0; i < 1000; ++i)
+		nums.push_back(i);
+	std::vector<bool> even = pool_map(pool, nums.begin(), nums.end(), [](int v)
+									  { return v % 2 == 0; });
+	int evens = 0;
+	for (std::size_t i = 0; i < even.size(); ++i)
+		evens += even[i];
+	std::cout << "- pool_map bool su 1000 interi : pari = " << evens << std::endl;
+
+	std::cout << "- task eseguiti = " << pool.executed() << ", code vuote : "
+			  << (pool.queue_depth(0) + pool.queue_depth(1) + pool.queue_depth(2) + pool.queue_depth(3) == 0 ? "true" : "false")
+			  << ", max profondita' > 0 : " << (pool.max_queue_depth() > 0 ? "true" : "false") << std::endl;
+
+	// Un task che lancia un'eccezione: wait() la rilancia
+	pool.submit([]
+				{ throw myexcp_domain_error("errore nel task"); });
+	try
+	{
+		pool.wait();
+	}
+	catch (myexcp_domain_error &e)
+	{
+		std::cout << "- eccezione dal task: " << e.what() << std::endl;
+	}
+}
+
+/**
+	@brief test sul Set partizionato
+	Test di ShardedSet: inserimenti concorrenti, snapshot e bilanciamento degli shard
+  */
+void test_sharded_set()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sul Set concorrente a shard
+	std::cout << "\n\n--- TEST SU SHARDED SET ---\n"
+			  << std::endl;
+
+	ShardedSet<int, int_equal> set(8);
+	std::cout << "- " << set.shards() << " shard" << std::endl;
+
+	set.add(1);
+	set.add(2);
+	std::cout << "\tadd(3) : " << (set.add(3) ? "true" : "false") << ", add(3) : " << (set.add(3) ? "true" : "false")
+			  << ", remove(2) : " << (set.remove(2) ? "true" : "false") << ", remove(2) : " << (set.remove(2) ? "true" : "false")
+			  << std::endl;
+	std::cout << "\t" << set << ", size = " << set.size() << std::endl;
+	set.clear();
+
+	// 4 thread inseriscono intervalli sovrapposti e cercano elementi: ogni elemento va aggiunto una volta
+	std::cout << "- add concorrenti da 4 thread" << std::endl;
+	std::vector<std::thread> threads;
+	std::vector<int> added(4, 0), found(4, 0);
+	for (int t = 0; t < 4; ++t)
+		threads.push_back(std::thread([&set, &added, &found, t]
+									  {
+			for (int i = t * 5000; i < t * 5000 + 10000; ++i)
+			{
+				added[t] += set.add(i);
+				found[t] += set.find(i);
+			} }));
+	for (int t = 0; t < 4; ++t)
+		threads[t].join();
+	std::cout << "\taggiunti = " << added[0] + added[1] + added[2] + added[3] << ", trovati = "
+			  << found[0] + found[1] + found[2] + found[3] << ", size = " << set.size() << std::endl;
+
+	// rimozione concorrente dei pari mentre altri thread leggono
+	std::cout << "- remove concorrenti dei pari" << std::endl;
+	threads.clear();
+	std::vector<int> removed(4, 0);
+	for (int t = 0; t < 4; ++t)
+		threads.push_back(std::thread([&set, &removed, t]
+									  {
+			for (int i = 0; i < 25000; i += 2)
+				removed[t] += set.remove(i);
+			for (int i = 1; i < 25000; i += 2)
+				set.contains(i); }));
+	for (int t = 0; t < 4; ++t)
+		threads[t].join();
+
+	unsigned int max_shard = 0, min_shard = set.size();
+	for (std::size_t i = 0; i < set.shards(); ++i)
+	{
+		max_shard = std::max(max_shard, set.shard_size(i));
+		min_shard = std::min(min_shard, set.shard_size(i));
+	}
+	std::cout << "\trimossi = " << removed[0] + removed[1] + removed[2] + removed[3] << ", size = " << set.size()
+			  << ", snapshot size = " << set.snapshot().size() << ", find(7) : " << (set.find(7) ? "true" : "false")
+			  << ", find(8) : " << (set.find(8) ? "true" : "false") << std::endl;
+	std::cout << "\tshard bilanciati (max < 2 * min) : " << (max_shard < 2 * min_shard ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test su MinHash
+	Test della stima di similarita' di Jaccard con MinHash e della ricerca di quasi duplicati con LSH
+  */
+void test_minhash()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sulle firme MinHash e sull'indice LSH
+	std::cout << "\n\n--- TEST SU MINHASH ---\n"
+			  << std::endl;
+
+	// [0, 1000) e [200, 1200): Jaccard esatto 800 / 1200
+	Set<int, int_equal> set1, set2;
+	for (int i = 0; i < 1000; ++i)
+		set1.add(i);
+	for (int i = 200; i < 1200; ++i)
+		set2.add(i);
+	MinHash<> sig1(set1, 256), sig2(set2, 256);
+	double exact = double((set1 - set2).size()) / (set1 + set2).size();
+	std::cout << "- Jaccard esatto = " << exact << ", errore della stima < 0.1 : "
+			  << (std::abs(sig1.similarity(sig2) - exact) < 0.1 ? "true" : "false") << std::endl;
+
+	// aggiornamento incrementale e merge
+	MinHash<> inc(256);
+	for (Set<int, int_equal>::const_iterator it = set1.begin(); it != set1.end(); ++it)
+		inc.add(*it);
+	std::cout << "- firma incrementale == firma del Set : " << (inc.similarity(sig1) == 1.0 ? "true" : "false");
+	MinHash<> uni = sig1;
+	uni.merge(sig2);
+	std::cout << ", merge == firma dell'unione : " << (uni.similarity(MinHash<>(set1 + set2, 256)) == 1.0 ? "true" : "false")
+			  << std::endl;
+
+	try
+	{
+		sig1.similarity(MinHash<>(set1, 64));
+	}
+	catch (myexcp_domain_error &e)
+	{
+		std::cout << "- " << e.what() << std::endl;
+	}
+
+	// 20 Set: le coppie (2i, 2i+1) sono quasi duplicate, le altre disgiunte
+	std::vector<MinHash<> > sigs;
+	for (int g = 0; g < 10; ++g)
+	{
+		Set<int, int_equal> a, b;
+		for (int i = 0; i < 500; ++i)
+		{
+			a.add(g * 10000 + i);
+			b.add(g * 10000 + i + (i < 10 ? 5000 : 0));
+		}
+		sigs.push_back(MinHash<>(a, 128));
+		sigs.push_back(MinHash<>(b, 128));
+	}
+	std::vector<double> sim = minhash_similarities(sigs);
+	std::cout << "- sim(0, 1) > 0.9 : " << (sim[0 * 20 + 1] > 0.9 ? "true" : "false") << ", sim(0, 2) < 0.1 : "
+			  << (sim[0 * 20 + 2] < 0.1 ? "true" : "false") << std::endl;
+
+	minhash_lsh lsh(32, 4);
+	for (std::size_t i = 0; i < sigs.size(); ++i)
+		lsh.insert(sigs[i]);
+	std::vector<std::pair<std::size_t, std::size_t> > pairs = lsh.candidate_pairs();
+	bool near = true;
+	for (std::size_t i = 0; i < pairs.size(); ++i)
+		near = near && pairs[i].first / 2 == pairs[i].second / 2;
+	std::cout << "- LSH: " << pairs.size() << " coppie candidate, tutte quasi duplicate : " << (near ? "true" : "false")
+			  << ", candidati di sigs[6] = " << lsh.candidates(sigs[6]).size() << std::endl;
+}
+
+/**
+	@brief test su HyperLogLog
+	Test della stima della cardinalita' con HyperLogLog, dell'unione di sketch e dei parametri errati
+  */
+void test_hyperloglog()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sugli sketch HyperLogLog
+	std::cout << "\n\n--- TEST SU HYPERLOGLOG ---\n"
+			  << std::endl;
+
+	// tre Set sovrapposti: [0, 30000), [20000, 50000), [40000, 70000)
+	OpenHashSet<int, int_equal> set1, set2, set3;
+	for (int i = 0; i < 30000; ++i)
+	{
+		set1.add(i);
+		set2.add(i + 20000);
+		set3.add(i + 40000);
+	}
+	HyperLogLog<> hll1(set1), hll2(set2), hll3(set3);
+	std::cout << "- errore |set1| < 3% : " << (std::abs(hll1.estimate() - 30000) < 900 ? "true" : "false") << std::endl;
+
+	HyperLogLog<> uni = hll1 + hll2 + hll3;
+	std::cout << "- errore |set1 + set2 + set3| (70000) < 3% : " << (std::abs(uni.estimate() - 70000) < 2100 ? "true" : "false")
+			  << std::endl;
+	std::cout << "- errore |set1 - set2| (10000) < 1500 : "
+			  << (std::abs(hll_intersection(hll1, hll2) - 10000) < 1500 ? "true" : "false") << std::endl;
+
+	// insieme piccolo: linear counting, duplicati ignorati
+	HyperLogLog<> small(10);
+	for (int i = 0; i < 100; ++i)
+	{
+		small.add(i);
+		small.add(i);
+	}
+	std::cout << "- errore |{0..99}| < 5 : " << (std::abs(small.estimate() - 100) < 5 ? "true" : "false")
+			  << ", vuoto = " << HyperLogLog<>(8).estimate() << std::endl;
+
+	try
+	{
+		small.merge(hll1);
+	}
+	catch (myexcp_domain_error &e)
+	{
+		std::cout << "- " << e.what() << std::endl;
+	}
+	try
+	{
+		HyperLogLog<> wrong(30);
+	}
+	catch (myexcp_out_of_range &e)
+	{
+		std::cout << "- " << e.what() << std::endl;
+	}
+}
+
+/**
+	Stampa le modifiche di un change log
+*/
+void print_changes(const std::vector<set_change<int> > &changes)
+{
+	for (std::size_t i = 0; i < changes.size(); ++i)
+		std::cout << " " << changes[i].seq << (changes[i].kind == CHANGE_ADD ? ":+" : ":-") << changes[i].val;
+	std::cout << std::endl;
+}
+
+/**
+	@brief test sul change log
+	Test della registrazione delle modifiche di un Set e della lettura con changes_since
+  */
+void test_change_log()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sul change log delle modifiche
+	std::cout << "\n\n--- TEST SU CHANGE LOG ---\n"
+			  << std::endl;
+
+	Set<int, int_equal> set;
+	set.add(100);
+	std::cout << "- change log disattivato: changes() == nullptr : " << (set.changes() == nullptr ? "true" : "false")
+			  << std::endl;
+
+	set.set_change_log(8);
+	set.add(1);
+	set.add(2);
+	set.add(2);	   // duplicato: non registrato
+	set.remove(7); // assente: non registrato
+	set.remove(1);
+	int vals[] = {3, 4, 3, 100};
+	set.insert(vals, vals + 4);
+
+	std::vector<set_change<int> > changes;
+	std::cout << "- dopo add(1), add(2), add(2), remove(7), remove(1), insert({3, 4, 3, 100}):";
+	set.changes_since(0, changes);
+	print_changes(changes);
+
+	// consumatore incrementale: legge solo le modifiche successive all'ultima sequenza vista
+	unsigned long long seen = set.changes()->last_sequence();
+	set.remove_if(int_is_positive());
+	changes.clear();
+	bool complete = set.changes_since(seen, changes);
+	std::cout << "- dopo remove_if(positivi), dal numero " << seen << " (completo : " << (complete ? "true" : "false")
+			  << "):";
+	print_changes(changes);
+
+	// buffer circolare: le modifiche piu' vecchie vengono sovrascritte
+	for (int i = 10; i < 20; ++i)
+		set.add(i);
+	changes.clear();
+	complete = set.changes_since(seen, changes);
+	std::cout << "- dopo 10 add, dal numero " << seen << " (completo : " << (complete ? "true" : "false")
+			  << ", prima sequenza conservata " << set.changes()->first_sequence() << "):";
+	print_changes(changes);
+
+	// clear e assegnamento registrano rimozioni e aggiunte
+	Set<int, int_equal> other;
+	other.add(5);
+	set.set_change_log(32);
+	set = other;
+	changes.clear();
+	set.changes_since(0, changes);
+	std::cout << "- set_change_log(32) e set = {5}: " << changes.size() << " modifiche, ultima:";
+	print_changes(std::vector<set_change<int> >(changes.end() - 1, changes.end()));
+
+	// un consumatore che ha letto il log precedente ha una sequenza piu' grande di quella corrente
+	set.set_change_log(16);
+	set.add(6);
+	changes.clear();
+	complete = set.changes_since(seen, changes);
+	std::cout << "- set_change_log(16), add(6), dal vecchio numero " << seen << " (completo : "
+			  << (complete ? "true" : "false") << "):";
+	print_changes(changes);
+	std::cout << "- la copia non eredita il change log : "
+			  << (Set<int, int_equal>(set).changes() == nullptr ? "true" : "false") << std::endl;
+}
+
+/**
+	@brief test sulle viste filtrate
+	Test di filter_view eager e lazy aggiornate dal change log del Set sorgente
+  */
+void test_filter_view()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sulle viste filtrate materializzate
+	std::cout << "\n\n--- TEST SU FILTER VIEW ---\n"
+			  << std::endl;
+
+	Set<int, int_equal> set;
+	int vals[] = {-3, -1, 0, 2, 5};
+	set.insert(vals, vals + 5);
+
+	auto eager = make_filter_view(set, int_is_positive());
+	auto lazy = make_filter_view(set, int_is_positive(), VIEW_LAZY);
+	std::cout << "- sorgente " << set << ", vista (eager) " << eager.contents().size() << " elementi, (lazy) "
+			  << lazy.size() << " elementi" << std::endl;
+
+	set.add(7);
+	set.add(-8);
+	set.add(7);
+	set.remove(2);
+	set.remove(-3);
+	std::cout << "- dopo add(7), add(-8), add(7), remove(2), remove(-3): find(7) : " << (eager.find(7) ? "true" : "false")
+			  << ", find(2) : " << (eager.find(2) ? "true" : "false") << ", size eager = " << eager.size()
+			  << ", size lazy = " << lazy.size() << ", ricostruzioni = " << eager.rebuilds() + lazy.rebuilds() << std::endl;
+
+	// sostituzione del change log: entrambe le viste si ricostruiscono alla lettura successiva
+	set.set_change_log(4);
+	for (int i = 10; i < 20; ++i)
+		set.add(i);
+	std::cout << "- set_change_log(4) e 10 add: size eager = " << eager.size() << ", size lazy = " << lazy.size()
+			  << ", ricostruzioni eager = " << eager.rebuilds() << ", lazy = " << lazy.rebuilds() << std::endl;
+
+	set.add(30);
+	set.remove(10);
+	std::cout << "- add(30), remove(10): size eager = " << eager.size() << ", size lazy = " << lazy.size()
+			  << ", ricostruzioni eager = " << eager.rebuilds() << std::endl;
+
+	// la vista lazy non legge in tempo le modifiche: il buffer viene sovrascritto e si ricostruisce
+	for (int i = 40; i < 50; ++i)
+		set.add(i);
+	std::cout << "- altre 10 add: size eager = " << eager.size() << ", size lazy = " << lazy.size()
+			  << ", ricostruzioni eager = " << eager.rebuilds() << ", lazy = " << lazy.rebuilds() << std::endl;
+
+	// confronto con filter_out
+	std::cout << "- uguale a filter_out : "
+			  << (filter_out(set, int_is_positive()).size() == eager.size() ? "true" : "false") << std::endl;
+
+	// vista piu' longeva della sorgente
+	Set<int, int_equal> *tmp = new Set<int, int_equal>(vals, vals + 5);
+	auto orphan = make_filter_view(*tmp, int_is_positive());
+	delete tmp;
+	std::cout << "- sorgente distrutta, ultimo contenuto della vista: " << orphan.size() << " elementi" << std::endl;
+
+	// assegnamento e clear che lanciano ad ogni copia possibile: la vista resta coerente col Set
+	const char *texts[] = {"a", "bb", "ccc"};
+	const char *other_texts[] = {"dd", "e"};
+	Set<copy_bomb, copy_bomb_equal> bombs(texts, texts + 3);
+	Set<copy_bomb, copy_bomb_equal> other(other_texts, other_texts + 2);
+	filter_view<copy_bomb, copy_bomb_equal, copy_bomb_is_long, copy_bomb_hash> long_bombs(bombs, copy_bomb_is_long());
+	bool coherent = long_bombs.size() == 2;
+	for (int which = 0; which < 2; ++which)
+		for (int countdown = 1; bombs.size() != (which == 0 ? 2u : 0u); ++countdown)
+		{
+			copy_bomb::countdown = countdown;
+			try
+			{
+				if (which == 0)
+					bombs = other;
+				else
+					bombs.clear();
+			}
+			catch (myexcp_domain_error &e)
+			{
+			}
+			copy_bomb::countdown = 0;
+			coherent = coherent && long_bombs.size() == filter_out(bombs, copy_bomb_is_long()).size();
+			for (Set<copy_bomb, copy_bomb_equal>::const_iterator it = bombs.begin(); it != bombs.end(); ++it)
+				coherent = coherent && long_bombs.find(*it) == copy_bomb_is_long()(*it);
+		}
+	std::cout << "- assegnamento e clear interrotti da eccezioni: vista sempre coerente : "
+			  << (coherent ? "true" : "false") << ", find(dd) : " << (long_bombs.find("dd") ? "true" : "false")
+			  << ", size = " << long_bombs.size() << std::endl;
+}
+
+/**
+	@brief test sugli indici secondari
+	Test di sorted_index e hash_index su dati di tipo person aggiornati dal change log
+  */
+void test_secondary_index()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sugli indici secondari
+	std::cout << "\n\n--- TEST SU INDICI SECONDARI ---\n"
+			  << std::endl;
+
+	person people[] = {{"Ugo", "Ughi", 32}, {"Ugo", "Ughi", 7}, {"Ada", "Adi", 87}, {"Ian", "Iani", 16},
+					   {"Leo", "Lei", 46}, {"Mia", "Ughi", 25}, {"Eva", "Evi", 4}};
+	Set<person, person_equal> setp(people, people + 7);
+
+	sorted_index<person, person_equal, person_age> by_age(setp);
+	hash_index<person, person_equal, person_surname> by_surname(setp);
+
+	// stessa selezione di filter_out(setp, person_is_old()), ma in ordine di eta'
+	std::cout << "- eta' > 25:";
+	sorted_index<person, person_equal, person_age>::range_type old = by_age.above(25);
+	for (sorted_index<person, person_equal, person_age>::const_iterator it = old.begin(); it != old.end(); ++it)
+		std::cout << " " << it->name << " " << it->age;
+	std::cout << " (" << old.size() << " come filter_out : " << filter_out(setp, person_is_old()).size() << ")" << std::endl;
+
+	std::cout << "- eta' in [7, 26):";
+	sorted_index<person, person_equal, person_age>::range_type young = by_age.range(7, 26);
+	for (sorted_index<person, person_equal, person_age>::const_iterator it = young.begin(); it != young.end(); ++it)
+		std::cout << " " << it->name << " " << it->age;
+	std::cout << std::endl;
+
+	std::cout << "- cognome Ughi: " << by_surname.count("Ughi") << " persone, Iani: " << by_surname.count("Iani")
+			  << ", Rossi: " << by_surname.count("Rossi") << std::endl;
+
+	// gli indici seguono add e remove sul Set
+	person p = {"Noa", "Ughi", 60};
+	setp.add(p);
+	setp.remove(people[0]);
+	setp.remove(people[0]);
+	std::cout << "- add(Noa Ughi 60), remove(Ugo Ughi 32): eta' > 25 = " << by_age.above(25).size()
+			  << ", cognome Ughi = " << by_surname.count("Ughi") << ", eta' == 60 : "
+			  << by_age.equal(60).begin()->name << std::endl;
+
+	// sostituzione del change log: ricostruzione alla ricerca successiva
+	setp.set_change_log(16);
+	setp.remove_if(person_is_old());
+	std::cout << "- remove_if(eta' > 25): indice per eta' " << by_age.size() << " elementi, eta' > 25 = "
+			  << by_age.above(25).size() << ", per cognome " << by_surname.size() << " elementi" << std::endl;
+}
+
+/**
+	@brief test sul Set a skip list
+	Test dell'interfaccia di SkipListSet (Set ordinato a skip list)
+  */
+void test_skiplist_set()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sul Set ordinato a skip list
+	std::cout << "\n\n--- TEST SU SKIPLIST SET ---\n"
+			  << std::endl;
+
+	int vals[] = {42, 7, -5, 19, 7, 100, 0, 63};
+	SkipListSet<int, int_equal> set(vals, vals + 8);
+	std::cout << "- set = " << set << ", size = " << set.size() << ", set[3] = " << set[3] << std::endl;
+
+	std::cout << "- lower_bound(8) = " << *set.lower_bound(8) << ", upper_bound(19) = " << *set.upper_bound(19)
+			  << ", upper_bound(100) == end() : " << (set.upper_bound(100) == set.end() ? "true" : "false") << std::endl;
+
+	std::pair<SkipListSet<int, int_equal>::const_iterator, SkipListSet<int, int_equal>::const_iterator> r = set.equal_range(42);
+	std::cout << "- equal_range(42) = [" << *r.first << ", " << *r.second << "), equal_range(43) vuoto : "
+			  << (set.equal_range(43).first == set.equal_range(43).second ? "true" : "false") << std::endl;
+
+	std::cout << "- rank(19) = " << set.rank(19) << ", rank(20) = " << set.rank(20) << ", count_in_range(0, 50) = "
+			  << set.count_in_range(0, 50) << ", count_in_range(50, 0) = " << set.count_in_range(50, 0)
+			  << ", nth(6) = " << *set.nth(6) << std::endl;
+
+	set.remove(19);
+	set.remove(19);
+	set.add(20);
+	std::cout << "- remove(19), add(20): " << set << ", rank(42) = " << set.rank(42) << std::endl;
+
+	// molti elementi: rango e intervalli coerenti con la scansione lineare
+	SkipListSet<int, int_equal> big;
+	for (int i = 0; i < 20000; ++i)
+		big.add((i * 7919) % 20000);
+	for (int i = 0; i < 20000; i += 2)
+		big.remove(i);
+	bool ordered = true;
+	int prev = -1;
+	unsigned int in_range = 0;
+	for (SkipListSet<int, int_equal>::const_iterator it = big.begin(); it != big.end(); ++it)
+	{
+		ordered = ordered && *it > prev;
+		prev = *it;
+		in_range += (*it >= 5000 && *it < 15000);
+	}
+	std::cout << "- 20000 add e 10000 remove: size = " << big.size() << ", ordinato : " << (ordered ? "true" : "false")
+			  << ", big[777] = " << big[777] << ", count_in_range(5000, 15000) = " << big.count_in_range(5000, 15000)
+			  << " (scansione: " << in_range << ")" << std::endl;
+
+	SkipListSet<int, int_equal> copy = big;
+	copy.remove_if(int_is_positive());
+	std::cout << "- copia == originale : " << (SkipListSet<int, int_equal>(big) == big ? "true" : "false")
+			  << ", remove_if(positivi) sulla copia: size = " << copy.size() << std::endl;
+
+	// copia interrotta da un'eccezione: i nodi gia' copiati vengono distrutti
+	SkipListSet<copy_bomb, copy_bomb_equal> bombs;
+	bombs.add("a");
+	bombs.add("b");
+	bombs.add("c");
+	bombs.add("d");
+	copy_bomb::countdown = 3;
+	try
+	{
+		SkipListSet<copy_bomb, copy_bomb_equal> bombs_copy(bombs);
+	}
+	catch (myexcp_domain_error &e)
+	{
+		std::cout << "- copia di " << bombs << ": " << e.what() << std::endl;
+	}
+
+	try
+	{
+		set[100];
+	}
+	catch (myexcp_out_of_range &e)
+	{
+		std::cout << "- " << e.what() << std::endl;
+	}
+}
+
+/**
+	@brief test sul Set statico
+	Test di StaticSet costruito durante la compilazione con hash perfetto
+  */
+void test_static_set()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sul Set costruito a tempo di compilazione
+	std::cout << "\n\n--- TEST SU STATIC SET ---\n"
+			  << std::endl;
+
+	static constexpr auto primes = make_static_set({13, 2, 7, 3, 11, 2, 5, 7, 13});
+	static_assert(primes.size() == 6, "duplicati non eliminati");
+	static_assert(primes.find(11) && !primes.find(4) && !primes.find(100) && !primes.find(-1), "find errata");
+	static_assert(primes[0] == 2 && primes[5] == 13, "elementi non ordinati");
+	static_assert(primes.index_of(7) == 3 && primes.index_of(8) == primes.size(), "index_of errata");
+	static_assert(primes.perfect_hash(), "hash perfetto non trovato");
+	std::cout << "- primes = " << primes << ", size = " << primes.size() << ", primes[2] = " << primes[2] << std::endl;
+
+	static constexpr auto keywords = make_static_set<std::string_view>({"while", "if", "else", "for", "return", "if"});
+	static_assert(keywords.contains("return") && !keywords.contains("goto"), "find errata");
+	std::string word = "else";
+	std::cout << "- keywords = " << keywords << ", find(\"else\") : " << (keywords.find(word) ? "true" : "false")
+			  << ", find(\"elsif\") : " << (keywords.find(std::string("elsif")) ? "true" : "false") << std::endl;
+
+	// confronto con un Set a lista e iterazione
+	Set<int, int_equal> list;
+	for (StaticSet<int, 9>::const_iterator it = primes.begin(); it != primes.end(); ++it)
+		list.add(*it);
+	bool same = list.size() == primes.size();
+	for (int i = -5; i < 20; ++i)
+		same = same && list.find(i) == primes.find(i);
+	static constexpr auto shuffled = make_static_set({5, 3, 13, 11, 7, 2});
+	std::cout << "- stesse risposte del Set a lista : " << (same ? "true" : "false")
+			  << ", primes == {5, 3, 13, 11, 7, 2} : " << (primes == shuffled ? "true" : "false")
+			  << ", hash perfetto : " << (keywords.perfect_hash() ? "true" : "false") << std::endl;
+
+	try
+	{
+		primes[6];
+	}
+	catch (myexcp_out_of_range &e)
+	{
+		std::cout << "- " << e.what() << std::endl;
+	}
+}
+
+/**
+	@brief test sul Set congelato
+	Test di FrozenSet costruito a run time con hash perfetto, scrittura e lettura da file
+  */
+void test_frozen_set()
+{
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Test sul Set congelato con hash perfetto
+	std::cout << "\n\n--- TEST SU FROZEN SET ---\n"
+			  << std::endl;
+
+	Set<int, int_equal> list;
+	for (int i = 0; i < 5000; ++i)
+		list.add(i * 37 - 20000);
+	FrozenSet<int, int_equal> frozen = freeze(list);
+	bool same = frozen.size() == list.size();
+	for (int i = -25000; i < 170000; i += 7)
+		same = same && frozen.find(i) == list.find(i);
+	bool positions = true;
+	for (FrozenSet<int, int_equal>::const_iterator it = frozen.begin(); it != frozen.end(); ++it)
+		positions = positions && frozen[static_cast<int>(frozen.index_of(*it))] == *it;
+	std::cout << "- freeze di 5000 interi: size = " << frozen.size() << ", stesse risposte del Set a lista : "
+			  << (same ? "true" : "false") << ", index_of coerente : " << (positions ? "true" : "false")
+			  << ", index_of(1) == size() : " << (frozen.index_of(1) == frozen.size() ? "true" : "false") << std::endl;
+
+	// stringhe con hash trasparente, scrittura e lettura binaria
+	Set<std::string, string_equal> words;
+	words.add("alfa");
+	words.add("beta");
+	words.add("gamma");
+	words.add("delta");
+	FrozenSet<std::string, string_equal, string_hash> fw(words);
+	std::stringstream file;
+	bool written = write_frozen_set(file, fw);
+	FrozenSet<std::string, string_equal, string_hash> loaded;
+	bool was_read = read_frozen_set(file, loaded);
+	std::cout << "- parole: size = " << loaded.size() << ", scritto : " << (written ? "true" : "false")
+			  << ", letto : " << (was_read ? "true" : "false") << ", uguale : " << (loaded == fw ? "true" : "false")
+			  << ", find(\"gamma\") : " << (loaded.find("gamma") ? "true" : "false")
+			  << ", find(std::string_view(\"omega\")) : " << (loaded.find(std::string_view("omega")) ? "true" : "false") << std::endl;
+
+	// file corrotto o di un altro tipo: rifiutato, il FrozenSet non cambia
+	std::string bytes = file.str();
+	bytes[bytes.size() - 1] = 'x';
+	std::istringstream corrupt(bytes);
+	std::stringstream ints;
+	write_frozen_set(ints, frozen);
+	std::cout << "- file corrotto letto : " << (read_frozen_set(corrupt, loaded) ? "true" : "false")
+			  << ", file di interi letto come stringhe : " << (read_frozen_set(ints, loaded) ? "true" : "false")
+			  << ", size invariata = " << loaded.size() << std::endl;
+
+	// int e float hanno la stessa dimensione ma formati diversi
+	std::istringstream ints_again(ints.str());
+	FrozenSet<float, float_equal> floats;
+	std::cout << "- TAG int != TAG float : " << (frozen_io<int>::TAG != frozen_io<float>::TAG ? "true" : "false")
+			  << ", file di interi letto come float : " << (read_frozen_set(ints_again, floats) ? "true" : "false")
+			  << std::endl;
+
+	FrozenSet<int, int_equal> empty = freeze(Set<int, int_equal>());
+	std::cout << "- FrozenSet vuoto: size = " << empty.size() << ", find(0) : " << (empty.find(0) ? "true" : "false") << std::endl;
+	try
+	{
+		empty[0];
+	}
+	catch (myexcp_domain_error &e)
+	{
+		std::cout << "- " << e.what() << std::endl;
+	}
+}
+
 int main()
 {
 	test_int_set();
@@ -1691,6 +3637,31 @@ int main()
 	test_person_set();
 	test_sets_set();
 	test_const_iterator();
+	test_roaring_set();
+	test_hashed_set();
+	test_transparent_lookup();
+	test_batch_insert();
+	test_batch_remove();
+	test_find_many();
+	test_flat_set();
+	test_storage_policy();
+	test_adaptive_set();
+	test_reorder_policy();
+	test_iterator_checks();
+	test_erase();
+	test_try_api();
+	test_text_io();
+	test_parallel_algebra();
+	test_work_stealing();
+	test_sharded_set();
+	test_minhash();
+	test_hyperloglog();
+	test_change_log();
+	test_filter_view();
+	test_secondary_index();
+	test_skiplist_set();
+	test_static_set();
+	test_frozen_set();
 
 	return 0;
 }
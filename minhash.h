@@ -0,0 +1,336 @@
+#ifndef MINHASH_H
+#define MINHASH_H
+
+#include "set.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+  @brief classe MinHash
+
+  Firma MinHash di un insieme: per ognuna delle k funzioni di hash h_i viene conservato il minimo
+  di h_i sugli elementi. La probabilita' che due firme coincidano in una posizione e' la similarita'
+  di Jaccard |A - B| / |A + B| (intersezione su unione) dei due insiemi, quindi la frazione di posizioni uguali la stima
+  con errore standard circa 1 / sqrt(k), in O(k) invece che O(n * m).
+
+  La firma si aggiorna in O(k) ad ogni add sul Set. Un remove non si puo' annullare sui minimi:
+  dopo le rimozioni la firma va ricalcolata con assign. La firma dell'unione di due Set e' il
+  minimo posizione per posizione delle due firme (merge).
+
+  Si possono confrontare solo firme con stessi k, seme e funtore di hash.
+
+  @tparam Hash funtore di hash degli elementi
+*/
+template <typename Hash = set_hash>
+class MinHash
+{
+  std::vector<std::uint64_t> _mins; ///< minimo di ogni funzione di hash
+  std::uint64_t _seed;              ///< seme delle funzioni di hash
+  Hash _hash;                       ///< funtore di hash degli elementi
+
+public:
+  typedef std::uint64_t value_type;
+
+  /**
+    @brief Costruttore: firma dell'insieme vuoto
+
+    @param k numero di funzioni di hash (lunghezza della firma)
+    @param seed seme delle funzioni di hash
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  explicit MinHash(unsigned int k = 128, std::uint64_t seed = 0)
+      : _mins(k, std::numeric_limits<std::uint64_t>::max()), _seed(seed) {}
+
+  /**
+    @brief Costruttore: firma di un Set
+
+    @param mset Set di cui calcolare la firma
+    @param k numero di funzioni di hash
+    @param seed seme delle funzioni di hash
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename T, typename E, typename S>
+  explicit MinHash(const Set<T, E, S> &mset, unsigned int k = 128, std::uint64_t seed = 0)
+      : _mins(k, std::numeric_limits<std::uint64_t>::max()), _seed(seed)
+  {
+    assign(mset);
+  }
+
+  /**
+    @brief Ricalcola la firma a partire da un Set (ad esempio dopo delle remove)
+
+    @param mset Set di cui calcolare la firma
+  */
+  template <typename T, typename E, typename S>
+  void assign(const Set<T, E, S> &mset)
+  {
+    clear();
+    for (typename Set<T, E, S>::const_iterator it = mset.begin(); it != mset.end(); ++it)
+      add(*it);
+  }
+
+  /**
+    @brief Aggiorna la firma con un elemento aggiunto all'insieme
+
+    Le k funzioni di hash sono ottenute rimescolando un solo hash dell'elemento con k semi diversi.
+
+    @param val elemento aggiunto
+  */
+  template <typename K>
+  void add(const K &val)
+  {
+    std::uint64_t h = set_mix(static_cast<std::uint64_t>(_hash(val)) ^ _seed);
+    for (std::size_t i = 0; i < _mins.size(); ++i)
+    {
+      std::uint64_t hi = set_mix(h + (i + 1) * 0x9E3779B97F4A7C15ull);
+      if (hi < _mins[i])
+        _mins[i] = hi;
+    }
+  }
+
+  /**
+    @brief Unisce alla firma quella di un altro insieme
+
+    @param other firma dell'altro insieme (stessi k e seme)
+
+    @post la firma e' quella dell'unione dei due insiemi
+
+    @throw myexcp_domain_error se le firme non sono confrontabili
+  */
+  void merge(const MinHash &other)
+  {
+    if (!compatible(other))
+      SET_THROW(myexcp_domain_error("Incompatible MinHash signatures"));
+    for (std::size_t i = 0; i < _mins.size(); ++i)
+      if (other._mins[i] < _mins[i])
+        _mins[i] = other._mins[i];
+  }
+
+  /**
+    @brief Riporta la firma a quella dell'insieme vuoto
+  */
+  void clear()
+  {
+    for (std::size_t i = 0; i < _mins.size(); ++i)
+      _mins[i] = std::numeric_limits<std::uint64_t>::max();
+  }
+
+  /**
+    @brief Indica se la firma e' confrontabile con un'altra
+
+    @param other altra firma
+
+    @return true se le due firme hanno stessi k e seme
+  */
+  bool compatible(const MinHash &other) const
+  {
+    return _mins.size() == other._mins.size() && _seed == other._seed;
+  }
+
+  /**
+    @brief Stima della similarita' di Jaccard
+
+    @param other firma dell'altro insieme (stessi k e seme)
+
+    @return frazione delle posizioni uguali (1 per due insiemi vuoti)
+
+    @throw myexcp_domain_error se le firme non sono confrontabili
+  */
+  double similarity(const MinHash &other) const
+  {
+    if (!compatible(other))
+      SET_THROW(myexcp_domain_error("Incompatible MinHash signatures"));
+    if (_mins.empty())
+      return 1.0;
+    std::size_t equal = 0;
+    for (std::size_t i = 0; i < _mins.size(); ++i)
+      equal += (_mins[i] == other._mins[i]);
+    return double(equal) / _mins.size();
+  }
+
+  /**
+    @brief Lunghezza della firma
+
+    @return numero di funzioni di hash
+  */
+  unsigned int size() const
+  {
+    return _mins.size();
+  }
+
+  /**
+    @brief Accesso in lettura ad una posizione della firma
+
+    @param i posizione
+
+    @return minimo della funzione di hash i
+  */
+  std::uint64_t operator[](unsigned int i) const
+  {
+    return _mins[i];
+  }
+};
+
+/**
+  @brief Similarita' di Jaccard stimata per tutte le coppie di firme
+
+  @param sigs firme (tutte con stessi k e seme)
+
+  @return matrice n x n per righe: elemento i * n + j e' la similarita' stimata tra i e j
+
+  @throw myexcp_domain_error se due firme non sono confrontabili
+*/
+template <typename H>
+std::vector<double> minhash_similarities(const std::vector<MinHash<H> > &sigs)
+{
+  const std::size_t n = sigs.size();
+  std::vector<double> sim(n * n, 1.0);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = i + 1; j < n; ++j)
+      sim[i * n + j] = sim[j * n + i] = sigs[i].similarity(sigs[j]);
+  return sim;
+}
+
+/**
+  @brief classe minhash_lsh
+
+  Indice LSH a bande sulle firme MinHash: la firma e' divisa in b bande di r posizioni e due
+  insiemi diventano candidati se coincidono in tutte le posizioni di almeno una banda. Con
+  similarita' s la probabilita' di essere candidati e' 1 - (1 - s^r)^b: la soglia (1/b)^(1/r)
+  separa i quasi duplicati dagli insiemi diversi senza confrontare tutte le coppie.
+*/
+class minhash_lsh
+{
+  typedef std::unordered_map<std::uint64_t, std::vector<std::size_t> > bucket_map;
+
+  unsigned int _bands;             ///< numero di bande
+  unsigned int _rows;              ///< posizioni per banda
+  std::vector<bucket_map> _tables; ///< una tabella di bucket per banda
+  std::size_t _count;              ///< firme inserite
+
+  /**
+    @brief Chiave del bucket di una banda
+
+    @param sig firma
+    @param band indice della banda
+
+    @return hash delle r posizioni della banda
+  */
+  template <typename H>
+  std::uint64_t band_key(const MinHash<H> &sig, unsigned int band) const
+  {
+    std::uint64_t key = band;
+    for (unsigned int r = 0; r < _rows; ++r)
+      key = set_mix(key ^ sig[band * _rows + r]);
+    return key;
+  }
+
+  /**
+    @brief Verifica che una firma sia abbastanza lunga per le bande dell'indice
+
+    @param sig firma
+
+    @throw myexcp_domain_error se la firma ha meno di b * r posizioni
+  */
+  template <typename H>
+  void check(const MinHash<H> &sig) const
+  {
+    if (sig.size() < _bands * _rows)
+      SET_THROW(myexcp_domain_error("MinHash signature too short for LSH bands"));
+  }
+
+public:
+  /**
+    @brief Costruttore
+
+    @param bands numero di bande b
+    @param rows posizioni per banda r (le firme devono avere almeno b * r posizioni)
+  */
+  minhash_lsh(unsigned int bands, unsigned int rows) : _bands(bands), _rows(rows), _tables(bands), _count(0) {}
+
+  /**
+    @brief Inserisce una firma nell'indice
+
+    @param sig firma
+    @return identificativo della firma (ordine di inserimento, da 0)
+
+    @throw myexcp_domain_error se la firma ha meno di b * r posizioni
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename H>
+  std::size_t insert(const MinHash<H> &sig)
+  {
+    check(sig);
+    for (unsigned int b = 0; b < _bands; ++b)
+      _tables[b][band_key(sig, b)].push_back(_count);
+    return _count++;
+  }
+
+  /**
+    @brief Firme che condividono almeno una banda con sig
+
+    @param sig firma da cercare
+
+    @return identificativi dei candidati, crescenti e senza ripetizioni
+
+    @throw myexcp_domain_error se la firma ha meno di b * r posizioni
+  */
+  template <typename H>
+  std::vector<std::size_t> candidates(const MinHash<H> &sig) const
+  {
+    check(sig);
+    std::vector<char> seen(_count, 0);
+    for (unsigned int b = 0; b < _bands; ++b)
+    {
+      bucket_map::const_iterator it = _tables[b].find(band_key(sig, b));
+      if (it != _tables[b].end())
+        for (std::size_t i = 0; i < it->second.size(); ++i)
+          seen[it->second[i]] = 1;
+    }
+
+    std::vector<std::size_t> result;
+    for (std::size_t i = 0; i < _count; ++i)
+      if (seen[i])
+        result.push_back(i);
+    return result;
+  }
+
+  /**
+    @brief Tutte le coppie di firme inserite che condividono almeno una banda
+
+    @return coppie (i, j) con i < j, ordinate e senza ripetizioni
+  */
+  std::vector<std::pair<std::size_t, std::size_t> > candidate_pairs() const
+  {
+    std::vector<std::pair<std::size_t, std::size_t> > pairs;
+    for (unsigned int b = 0; b < _bands; ++b)
+      for (bucket_map::const_iterator it = _tables[b].begin(); it != _tables[b].end(); ++it)
+        for (std::size_t i = 0; i < it->second.size(); ++i)
+          for (std::size_t j = i + 1; j < it->second.size(); ++j)
+            pairs.push_back(std::make_pair(it->second[i], it->second[j]));
+
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    return pairs;
+  }
+
+  /**
+    @brief Numero di firme inserite
+
+    @return numero di firme
+  */
+  std::size_t size() const
+  {
+    return _count;
+  }
+};
+
+#endif
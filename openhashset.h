@@ -0,0 +1,881 @@
+#ifndef OPENHASHSET_H
+#define OPENHASHSET_H
+
+#include "set.h"
+
+#include <iostream>
+#include <iterator>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+  @brief classe Set (HashStorage)
+
+  La classe implementa un Set di elementi generici T unici come tabella hash a indirizzamento
+  aperto con scansione lineare. Accanto ad ogni cella viene memorizzato l'hash dell'elemento, cosi'
+  il ridimensionamento e i confronti non ricalcolano Hash e Equals viene chiamato solo quando gli
+  hash coincidono. Il fattore di carico (celle occupate o cancellate) resta sotto 3/4.
+
+  L'ordine di iterazione e' quello delle celle e cambia ad ogni ridimensionamento.
+  Il funtore Hash deve essere coerente con Equals: se Equals(a, b) allora Hash(a) == Hash(b).
+*/
+template <typename T, typename Equals, typename Hash>
+class Set<T, Equals, HashStorage<Hash> >
+{
+  typedef typename std::remove_cv<T>::type value_type;
+
+  /**
+    @brief Stato di una cella della tabella
+  */
+  enum slot_state
+  {
+    EMPTY,
+    FULL,
+    DELETED
+  };
+
+  static const std::size_t MIN_CAPACITY = 16;     ///< numero minimo di celle
+  static const std::size_t PREFETCH_DISTANCE = 8; ///< chiavi di anticipo per il prefetch in find_many
+
+  /**
+    @brief Cella da cui parte la scansione di un hash
+
+    L'hash viene rimescolato (moltiplicazione di Fibonacci) prima di prendere i bit della cella:
+    hash poco distribuiti nei bit bassi, come l'identita' di std::hash<int> su soli numeri pari,
+    creerebbero altrimenti lunghe sequenze di celle occupate.
+
+    @param h hash dell'elemento
+    @param mask numero di celle - 1
+
+    @return indice della cella iniziale
+  */
+  static std::size_t home(std::size_t h, std::size_t mask)
+  {
+    return static_cast<std::size_t>((static_cast<unsigned long long>(h) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+  }
+
+  /**
+    @brief ricerca di una chiave nella tabella
+
+    @param key chiave da cercare, confrontata con Equals(T, K)
+    @param h hash di key
+
+    @return indice della cella che contiene key, _cap se non esiste
+  */
+  template <typename K>
+  std::size_t find_internal(const K &key, std::size_t h) const
+  {
+    if (_size == 0)
+      return _cap;
+
+    std::size_t mask = _cap - 1;
+    std::size_t slot = home(h, mask);
+    while (_state[slot] != EMPTY)
+    {
+      if (_state[slot] == FULL && _hashes[slot] == h && _equals(_vals[slot], key))
+        return slot;
+      slot = (slot + 1) & mask;
+    }
+    return _cap;
+  }
+
+  /**
+    @brief Aggiunge un elemento di cui e' gia' noto l'hash
+
+    @param val valore da inserire nel set
+    @param h hash di val
+
+    @return true se val e' stato aggiunto, false se era gia' presente
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  bool add_hashed(const T &val, std::size_t h)
+  {
+    if (find_internal(val, h) != _cap)
+      return false;
+    if ((_used + 1) * 4 > _cap * 3)
+      rehash(_size + 1);
+
+    std::size_t mask = _cap - 1;
+    std::size_t slot = home(h, mask);
+    while (_state[slot] == FULL)
+      slot = (slot + 1) & mask;
+
+    new (static_cast<void *>(_vals + slot)) value_type(val);
+    if (_state[slot] == EMPTY)
+      ++_used;
+    _state[slot] = FULL;
+    _hashes[slot] = h;
+    ++_size;
+    return true;
+  }
+
+  /**
+    @brief Svuota la cella slot
+
+    @param slot indice di una cella FULL
+  */
+  void erase_slot(std::size_t slot)
+  {
+    _vals[slot].~value_type();
+    _state[slot] = DELETED;
+    --_size;
+  }
+
+  /**
+    @brief Ricostruisce la tabella con capacita' sufficiente per n elementi
+
+    Elimina anche le celle cancellate. Gli elementi vengono copiati (o spostati se lo spostamento
+    non puo' fallire): in caso di eccezione la tabella originale resta intatta.
+
+    @param n numero di elementi che la nuova tabella deve poter contenere
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void rehash(std::size_t n)
+  {
+    std::size_t cap = MIN_CAPACITY;
+    while (cap * 3 < n * 4)
+      cap *= 2;
+    if (cap < _cap && _used == _size)
+      return;
+
+    value_type *vals = static_cast<value_type *>(::operator new(cap * sizeof(value_type)));
+    std::vector<unsigned char> state;
+    std::vector<std::size_t> hashes;
+    std::size_t moved = 0;
+
+    SET_TRY
+    {
+      state.assign(cap, EMPTY);
+      hashes.assign(cap, 0);
+      for (std::size_t i = 0; i < _cap; ++i)
+      {
+        if (_state[i] != FULL)
+          continue;
+        std::size_t slot = home(_hashes[i], cap - 1);
+        while (state[slot] == FULL)
+          slot = (slot + 1) & (cap - 1);
+        new (static_cast<void *>(vals + slot)) value_type(std::move_if_noexcept(_vals[i]));
+        state[slot] = FULL;
+        hashes[slot] = _hashes[i];
+        ++moved;
+      }
+    }
+    SET_CATCH_ALL
+    {
+      for (std::size_t i = 0; i < state.size() && moved != 0; ++i)
+        if (state[i] == FULL)
+        {
+          vals[i].~value_type();
+          --moved;
+        }
+      ::operator delete(vals);
+      SET_RETHROW();
+    }
+
+    destroy();
+    _vals = vals;
+    _state.swap(state);
+    _hashes.swap(hashes);
+    _cap = cap;
+    _used = _size;
+  }
+
+  /**
+    @brief Distrugge tutti gli elementi e libera le celle (non modifica _size)
+  */
+  void destroy()
+  {
+    for (std::size_t i = 0; i < _cap; ++i)
+      if (_state[i] == FULL)
+        _vals[i].~value_type();
+    ::operator delete(_vals);
+    _vals = nullptr;
+    _state.clear();
+    _hashes.clear();
+    _cap = 0;
+    _used = 0;
+  }
+
+  value_type *_vals;                ///< celle della tabella (elemento costruito solo se FULL)
+  std::vector<unsigned char> _state; ///< stato di ogni cella
+  std::vector<std::size_t> _hashes;  ///< hash dell'elemento di ogni cella FULL
+  std::size_t _cap;                  ///< numero di celle (0 o potenza di 2)
+  std::size_t _used;                 ///< celle FULL o DELETED
+  unsigned int _size;                ///< numero di elementi nel Set
+  Equals _equals;                    ///< funtore per il confronto di eguaglianza tra dati T
+  Hash _hash;                        ///< funtore per il calcolo dell'hash dei dati T
+
+  template <typename U, typename E, typename H, typename P>
+  friend Set<U, E, HashStorage<H> > filter_out(const Set<U, E, HashStorage<H> > &mset, P pred);
+
+  template <typename U, typename E, typename H>
+  friend Set<U, E, HashStorage<H> > operator+(const Set<U, E, HashStorage<H> > &set1,
+                                              const Set<U, E, HashStorage<H> > &set2);
+
+  template <typename U, typename E, typename H>
+  friend Set<U, E, HashStorage<H> > operator-(const Set<U, E, HashStorage<H> > &set1,
+                                              const Set<U, E, HashStorage<H> > &set2);
+
+public:
+  /**
+    @brief Costruttore di default.
+
+    @post _size == 0
+  */
+  Set() : _vals(nullptr), _cap(0), _used(0), _size(0) {}
+
+  /**
+    @brief Copy constructor
+
+    @param other Set da copiare
+
+    @post Set chiamante contiene tutti e soli gli elementi di other.
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  Set(const Set &other) : _vals(nullptr), _cap(0), _used(0), _size(0)
+  {
+    SET_TRY
+    {
+      rehash(other._size);
+      for (std::size_t i = 0; i < other._cap; ++i)
+        if (other._state[i] == FULL)
+          add_hashed(other._vals[i], other._hashes[i]);
+    }
+    SET_CATCH_ALL
+    {
+      clear();
+      SET_ALLOC_ERROR();
+    }
+  }
+
+  /**
+    @brief Costruttore con coppia di iteratori generici
+
+    @param beg iteratore all'inizio della sequenza
+    @param end iteratore alla fine della sequenza
+
+    @post Set chiamante contiene tutti e soli gli elementi della sequenza tra beg e end
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Q>
+  Set(Q beg, Q end) : _vals(nullptr), _cap(0), _used(0), _size(0)
+  {
+    SET_TRY
+    {
+      while (beg != end)
+      {
+        add(static_cast<T>(*beg));
+        ++beg;
+      }
+    }
+    SET_CATCH_ALL
+    {
+      clear();
+      SET_ALLOC_ERROR();
+    }
+  }
+
+  /**
+    @brief Operatore di assegnamento
+
+    @param other Set da copiare
+
+    @return reference al Set this
+
+    @post Set chiamante contiene tutti e soli gli elementi di other.
+  */
+  Set &operator=(const Set &other)
+  {
+    if (this != &other)
+    {
+      Set tmp(other);
+      std::swap(_vals, tmp._vals);
+      _state.swap(tmp._state);
+      _hashes.swap(tmp._hashes);
+      std::swap(_cap, tmp._cap);
+      std::swap(_used, tmp._used);
+      std::swap(_size, tmp._size);
+    }
+    return *this;
+  }
+
+  /**
+    @brief Distruttore
+
+    @post _size == 0
+  */
+  ~Set()
+  {
+    clear();
+  }
+
+  /**
+    @brief Svuota il Set e libera la tabella
+
+    @post _size == 0
+  */
+  void clear()
+  {
+    destroy();
+    _size = 0;
+  }
+
+  /**
+    @brief Numero di elementi nel Set
+
+    @return numero di elementi nel Set
+  */
+  unsigned int size() const
+  {
+    return _size;
+  }
+
+  /**
+     @brief Operatore di lettura dell'elemento in posizione index (ordine delle celle)
+
+     @param index indice dell'elemento da leggere
+
+     @return reference all'elemento in posizione index
+
+     @throw myexcp::myexcp_domain_error se viene passato un Set vuoto
+     @throw myexcp::myexcp_out_of_range se viene passato un indice out of bounds
+   */
+  const T &operator[](int index) const
+  {
+    if (_size == 0)
+      SET_THROW(myexcp_domain_error("Empty Set"));
+    if (index < 0 || static_cast<unsigned int>(index) > _size - 1)
+      SET_THROW(myexcp_out_of_range("Index out of bounds"));
+
+    std::size_t slot = 0;
+    while (true)
+    {
+      if (_state[slot] == FULL && index-- == 0)
+        return _vals[slot];
+      ++slot;
+    }
+  }
+
+  /**
+    @brief Operatore di confronto (uguaglianza) tra due Set
+
+    @param other Set da confrontare
+
+    @return true se other e il Set chiamante contengono gli stessi elementi
+  */
+  bool operator==(const Set &other) const
+  {
+    if (_size != other._size)
+      return false;
+    for (std::size_t i = 0; i < _cap; ++i)
+      if (_state[i] == FULL && other.find_internal(_vals[i], _hashes[i]) == other._cap)
+        return false;
+    return true;
+  }
+
+  /**
+    @brief Aggiunge un elemento nel set assicurandosi che non sia gia' presente
+
+    @param val valore da inserire nel set
+
+    @post _size = _size+1 se val non era presente
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void add(const T &val)
+  {
+    add_hashed(val, _hash(val));
+  }
+
+  /**
+    @brief Prealloca le celle necessarie a contenere n elementi
+
+    @param n numero di elementi che il Set deve poter contenere senza ridimensionamenti
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void reserve(unsigned int n)
+  {
+    if (n * 4 > _cap * 3)
+      rehash(n);
+  }
+
+  /**
+    @brief Aggiunge al Set tutti gli elementi di una sequenza
+
+    @param first iteratore all'inizio della sequenza
+    @param last iteratore alla fine della sequenza
+
+    @return numero di elementi effettivamente aggiunti
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Iter>
+  unsigned int insert(Iter first, Iter last)
+  {
+    unsigned int added = 0;
+    while (first != last)
+    {
+      added += add_hashed(static_cast<T>(*first), _hash(static_cast<T>(*first)));
+      ++first;
+    }
+    return added;
+  }
+
+  /**
+    @brief Rimuove (se presente) un elemento dal set.
+
+    @param val valore da rimuovere dal set
+
+    @return true se val e' stato rimosso, false altrimenti
+  */
+  bool remove(const T &val)
+  {
+    std::size_t slot = find_internal(val, _hash(val));
+    if (slot == _cap)
+      return false;
+    erase_slot(slot);
+    return true;
+  }
+
+  /**
+    @brief Rimuove (se presente) l'elemento uguale ad una chiave di tipo qualsiasi
+
+    Disponibile solo se Equals e Hash sono trasparenti (definiscono is_transparent).
+
+    @param key chiave da rimuovere dal set
+
+    @return true se un elemento e' stato rimosso, false altrimenti
+  */
+  template <typename K, typename E = Equals, typename H = Hash,
+            typename = typename E::is_transparent, typename = typename H::is_transparent>
+  bool remove(const K &key)
+  {
+    std::size_t slot = find_internal(key, _hash(key));
+    if (slot == _cap)
+      return false;
+    erase_slot(slot);
+    return true;
+  }
+
+  /**
+    @brief Rimuove tutti gli elementi che soddisfano un predicato
+
+    @param pred predicato booleano sui dati T
+
+    @return numero di elementi rimossi
+  */
+  template <typename P>
+  unsigned int remove_if(P pred)
+  {
+    unsigned int removed = 0;
+    for (std::size_t i = 0; i < _cap; ++i)
+    {
+      if (_state[i] == FULL && pred(_vals[i]))
+      {
+        erase_slot(i);
+        ++removed;
+      }
+    }
+    return removed;
+  }
+
+  /**
+    @brief ricerca di un valore nel Set
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool find(const T &val) const
+  {
+    return find_internal(val, _hash(val)) != _cap;
+  }
+
+  /**
+    @brief ricerca di una chiave di tipo qualsiasi nel Set
+
+    Disponibile solo se Equals e Hash sono trasparenti (definiscono is_transparent).
+
+    @param key chiave da cercare nel Set
+
+    @return true se un elemento uguale a key e' presente nel Set, false altrimenti
+  */
+  template <typename K, typename E = Equals, typename H = Hash,
+            typename = typename E::is_transparent, typename = typename H::is_transparent>
+  bool find(const K &key) const
+  {
+    return find_internal(key, _hash(key)) != _cap;
+  }
+
+  /**
+    @brief Sinonimo di find
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool contains(const T &val) const
+  {
+    return find(val);
+  }
+
+  /**
+    @brief Sinonimo di find per chiavi di tipo qualsiasi (Equals e Hash trasparenti)
+
+    @param key chiave da cercare nel Set
+
+    @return true se un elemento uguale a key e' presente nel Set, false altrimenti
+  */
+  template <typename K, typename E = Equals, typename H = Hash,
+            typename = typename E::is_transparent, typename = typename H::is_transparent>
+  bool contains(const K &key) const
+  {
+    return find(key);
+  }
+
+  /**
+    @brief ricerca di una sequenza di valori nel Set
+
+    Vengono calcolati prima tutti gli hash delle chiavi; durante le ricerche la cella iniziale
+    della chiave a distanza PREFETCH_DISTANCE viene precaricata, cosi' i cache miss di ricerche
+    diverse si sovrappongono. Per ogni chiave viene scritto in out un bool (true se presente).
+
+    @param first iteratore all'inizio della sequenza di chiavi
+    @param last iteratore alla fine della sequenza di chiavi
+    @param out iteratore di output su cui scrivere i risultati, nell'ordine della sequenza
+
+    @return numero di chiavi della sequenza presenti nel Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Iter, typename OutIter>
+  unsigned int find_many(Iter first, Iter last, OutIter out) const
+  {
+    std::vector<value_type> keys;
+    while (first != last)
+    {
+      keys.push_back(static_cast<T>(*first));
+      ++first;
+    }
+    std::vector<std::size_t> hashes(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i)
+      hashes[i] = _hash(keys[i]);
+
+    unsigned int hits = 0;
+    std::size_t mask = _cap - 1;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+      if (_cap != 0 && i + PREFETCH_DISTANCE < keys.size())
+      {
+        std::size_t ahead = home(hashes[i + PREFETCH_DISTANCE], mask);
+        __builtin_prefetch(&_state[ahead]);
+        __builtin_prefetch(&_hashes[ahead]);
+      }
+      bool f = find_internal(keys[i], hashes[i]) != _cap;
+      hits += f;
+      *out = f;
+      ++out;
+    }
+    return hits;
+  }
+
+  /**
+    @brief stampa del Set nello standard output
+
+    Overloading dell'operatore << dello standard output per stampa del Set
+
+    @return ostream con il Set da stampare
+  */
+  friend std::ostream &operator<<(std::ostream &os, const Set &mset)
+  {
+    bool first = true;
+    os << "{";
+    for (std::size_t i = 0; i < mset._cap; ++i)
+    {
+      if (mset._state[i] != FULL)
+        continue;
+      if (!first)
+        os << ", ";
+      first = false;
+      os << mset._vals[i];
+    }
+    os << "}";
+    return os;
+  }
+
+  /**
+  @brief classe const_iterator
+
+  Classe interna di iteratori costanti (sola lettura) per iterare sul Set nell'ordine delle celle
+
+  */
+  class const_iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T val_type;
+    typedef typename std::remove_cv<T>::type value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const T *pointer;
+    typedef const T &reference;
+
+    /**
+      @brief Costruttore di default.
+    */
+    const_iterator() : _set(nullptr), _slot(0) {}
+
+    /**
+      @brief Copy constructor
+
+      @param other iteratore da copiare
+    */
+    const_iterator(const const_iterator &other) : _set(other._set), _slot(other._slot) {}
+
+    /**
+      @brief Operatore di assegnamento
+
+      @param other iteratore da copiare
+
+      @return reference all'iteratore this
+    */
+    const_iterator &operator=(const const_iterator &other)
+    {
+      _set = other._set;
+      _slot = other._slot;
+      return *this;
+    }
+
+    /**
+      @brief Distruttore
+    */
+    ~const_iterator() {}
+
+    /**
+      @brief Operatore di dereferenziamento
+
+      @return reference al valore dell'elemento corrente
+
+      @throw myexcp::myexcp_domain_error se viene dereferenziato end()
+    */
+    reference operator*() const
+    {
+#if SET_ITERATOR_CHECKS
+      if (_set == nullptr || _slot >= _set->_cap)
+        SET_THROW(myexcp_domain_error("Dereferencing end()"));
+#endif
+      return _set->_vals[_slot];
+    }
+
+    /**
+      @brief Operatore freccia
+
+      @return puntatore al valore dell'elemento corrente
+    */
+    pointer operator->() const
+    {
+      return &(operator*());
+    }
+
+    /**
+      @brief Operatore post incremento
+
+      @return copia dell'iteratore this (prima di essere incrementato)
+
+      @throw myexcp::myexcp_domain_error se viene incrementato end()
+    */
+    const_iterator operator++(int)
+    {
+      const_iterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    /**
+      @brief Operatore pre incremento
+
+      @return reference all'iteratore this (incrementato)
+
+      @throw myexcp::myexcp_domain_error se viene incrementato end()
+    */
+    const_iterator &operator++()
+    {
+#if SET_ITERATOR_CHECKS
+      if (_set == nullptr || _slot >= _set->_cap)
+        SET_THROW(myexcp_domain_error("Dereferencing end()"));
+#endif
+      ++_slot;
+      skip();
+      return *this;
+    }
+
+    /**
+    @brief Operatore di confronto (uguaglianza) tra due iteratori
+
+    @return true se i due iteratori puntano allo stesso elemento
+    */
+    bool operator==(const const_iterator &other) const
+    {
+      return _set == other._set && _slot == other._slot;
+    }
+
+    /**
+    @brief Operatore di confronto (disuguaglianza) tra due iteratori
+
+    @return true se i due iteratori non puntano allo stesso elemento
+    */
+    bool operator!=(const const_iterator &other) const
+    {
+      return !(*this == other);
+    }
+
+  private:
+    const Set *_set;   ///< Set su cui si itera
+    std::size_t _slot; ///< cella corrente (_set->_cap = fine)
+
+    friend class Set;
+
+    const_iterator(const Set *s, std::size_t slot) : _set(s), _slot(slot)
+    {
+      skip();
+    }
+
+    void skip()
+    {
+      while (_slot < _set->_cap && _set->_state[_slot] != FULL)
+        ++_slot;
+    }
+  };
+
+  /**
+      @brief Iteratore all'inizio del Set
+
+      @return copia dell'iteratore all'inizio del Set
+  */
+  const_iterator begin() const
+  {
+    return const_iterator(this, 0);
+  }
+
+  /**
+      @brief Iteratore alla fine del Set
+
+      @return copia dell'iteratore alla fine del Set
+  */
+  const_iterator end() const
+  {
+    return const_iterator(this, _cap);
+  }
+};
+
+/**
+  @brief Set a tabella hash a indirizzamento aperto
+
+  Nome breve di Set<T, Equals, HashStorage<Hash> >.
+*/
+template <typename T, typename Equals, typename Hash = set_hash>
+using OpenHashSet = Set<T, Equals, HashStorage<Hash> >;
+
+/**
+    @brief Crea un nuovo Set con tutti e soli gli elementi del Set di partenza che soddisfano un certo predicato
+
+    Gli hash memorizzati nelle celle vengono riusati.
+
+    @param mset Set di partenza
+    @param pred predicato booleano filtro
+
+    @return Set con tutti e soli gli elementi del Set di partenza che soddisfano il predicato P
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename H, typename P>
+Set<T, E, HashStorage<H> > filter_out(const Set<T, E, HashStorage<H> > &mset, P pred)
+{
+  Set<T, E, HashStorage<H> > out_set;
+
+  SET_TRY
+  {
+    for (std::size_t i = 0; i < mset._cap; ++i)
+      if (mset._state[i] == mset.FULL && pred(mset._vals[i]))
+        out_set.add_hashed(mset._vals[i], mset._hashes[i]);
+  }
+  SET_CATCH_ALL
+  {
+    SET_ALLOC_ERROR();
+  }
+  return out_set;
+}
+
+/**
+    @brief Unione di due Set
+
+    Parte da una copia del Set piu' grande e vi aggiunge l'altro riusando gli hash memorizzati.
+
+    @param set1 primo Set da unire
+    @param set2 secondo Set da unire
+
+    @return Set che contiene gli elementi di entrambi i Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename H>
+Set<T, E, HashStorage<H> > operator+(const Set<T, E, HashStorage<H> > &set1,
+                                     const Set<T, E, HashStorage<H> > &set2)
+{
+  const Set<T, E, HashStorage<H> > &big = (set1._size < set2._size) ? set2 : set1;
+  const Set<T, E, HashStorage<H> > &small = (set1._size < set2._size) ? set1 : set2;
+  Set<T, E, HashStorage<H> > out_set = big;
+
+  SET_TRY
+  {
+    out_set.reserve(big._size + small._size);
+    for (std::size_t i = 0; i < small._cap; ++i)
+      if (small._state[i] == small.FULL)
+        out_set.add_hashed(small._vals[i], small._hashes[i]);
+  }
+  SET_CATCH_ALL
+  {
+    SET_ALLOC_ERROR();
+  }
+  return out_set;
+}
+
+/**
+    @brief Intersezione di due Set
+
+    Scorre il Set piu' piccolo e cerca ogni elemento nell'altro con l'hash memorizzato.
+
+    @param set1 primo Set da intersecare
+    @param set2 secondo Set da intersecare
+
+    @return Set che contiene gli elementi comuni ad entrambi i Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename H>
+Set<T, E, HashStorage<H> > operator-(const Set<T, E, HashStorage<H> > &set1,
+                                     const Set<T, E, HashStorage<H> > &set2)
+{
+  const Set<T, E, HashStorage<H> > &big = (set1._size < set2._size) ? set2 : set1;
+  const Set<T, E, HashStorage<H> > &small = (set1._size < set2._size) ? set1 : set2;
+  Set<T, E, HashStorage<H> > out_set;
+
+  SET_TRY
+  {
+    for (std::size_t i = 0; i < small._cap; ++i)
+      if (small._state[i] == small.FULL && big.find_internal(small._vals[i], small._hashes[i]) != big._cap)
+        out_set.add_hashed(small._vals[i], small._hashes[i]);
+  }
+  SET_CATCH_ALL
+  {
+    SET_ALLOC_ERROR();
+  }
+  return out_set;
+}
+
+#endif
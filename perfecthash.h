@@ -0,0 +1,151 @@
+#ifndef PERFECTHASH_H
+#define PERFECTHASH_H
+
+#include "storage.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+  @brief Funzione hash perfetta minimale con hash and displace (StaticSet, FrozenSet)
+
+  Gli n elementi, dati dai loro hash, sono divisi in n bucket da bucket(); ad ogni bucket, dal piu'
+  numeroso, viene assegnato il primo spostamento d che manda tutti i suoi elementi in posizioni
+  slot(h, d) libere di [0, n). Una ricerca calcola quindi la posizione con un solo accesso alla
+  tabella degli spostamenti.
+
+  Tutte le funzioni sono constexpr e non allocano: StaticSet le esegue durante la compilazione su
+  array, FrozenSet a run time sui buffer di std::vector.
+*/
+struct perfect_hash
+{
+  static constexpr std::uint32_t EMPTY = 0xffffffffu; ///< posizione libera in owner
+
+  /**
+    @brief Riduce 32 bit di hash all'intervallo [0, n) con una moltiplicazione
+
+    @return valore in [0, n)
+  */
+  static constexpr std::size_t reduce(std::uint64_t h, std::size_t n)
+  {
+    return static_cast<std::size_t>(((h & 0xffffffffull) * n) >> 32);
+  }
+
+  /**
+    @brief Bucket di un hash (dai 32 bit alti)
+
+    @param h hash dell'elemento
+    @param n numero di elementi (e di bucket)
+
+    @return bucket in [0, n)
+  */
+  static constexpr std::size_t bucket(std::uint64_t h, std::size_t n)
+  {
+    return reduce(h >> 32, n);
+  }
+
+  /**
+    @brief Posizione di un hash con lo spostamento del suo bucket
+
+    @param h hash dell'elemento
+    @param disp spostamento del bucket
+    @param n numero di elementi
+
+    @return posizione in [0, n)
+  */
+  static constexpr std::size_t slot(std::uint64_t h, std::uint32_t disp, std::size_t n)
+  {
+    return reduce(set_mix(h + disp * 0x9e3779b97f4a7c15ull), n);
+  }
+
+  /**
+    @brief Dimensione del buffer di lavoro di place
+
+    @param n numero di elementi
+
+    @return numero di std::size_t necessari
+  */
+  static constexpr std::size_t scratch_size(std::size_t n)
+  {
+    return 4 * n + 3;
+  }
+
+  /**
+    @brief Calcola gli spostamenti e la posizione di ogni elemento
+
+    @param hashes hash degli n elementi
+    @param n numero di elementi
+    @param max_disp spostamenti provati per ogni bucket prima di rinunciare
+    @param disp spostamento di ogni bucket (n valori, in uscita)
+    @param owner indice dell'elemento in ogni posizione (n valori, in uscita)
+    @param scratch buffer di lavoro di scratch_size(n) valori
+
+    @return false se per qualche bucket non esiste uno spostamento valido (es. hash identici)
+  */
+  static constexpr bool place(const std::uint64_t *hashes, std::size_t n, std::uint32_t max_disp,
+                              std::uint32_t *disp, std::uint32_t *owner, std::size_t *scratch)
+  {
+    std::size_t *start = scratch;         // start[b]: primo elemento del bucket b in members
+    std::size_t *members = start + n + 1; // indici degli elementi raggruppati per bucket
+    std::size_t *order = members + n;     // bucket in ordine di dimensione decrescente
+    std::size_t *by_size = order + n;     // contatori del counting sort
+
+    for (std::size_t b = 0; b <= n; ++b)
+      start[b] = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      ++start[bucket(hashes[i], n) + 1];
+    for (std::size_t b = 0; b < n; ++b)
+      start[b + 1] += start[b];
+    // order fa da cursore di riempimento dei bucket prima di essere calcolato
+    for (std::size_t b = 0; b < n; ++b)
+      order[b] = start[b];
+    for (std::size_t i = 0; i < n; ++i)
+      members[order[bucket(hashes[i], n)]++] = i;
+
+    // counting sort dei bucket per dimensione decrescente (a parita' di dimensione per indice)
+    for (std::size_t c = 0; c < n + 2; ++c)
+      by_size[c] = 0;
+    for (std::size_t b = 0; b < n; ++b)
+      ++by_size[n - (start[b + 1] - start[b]) + 1];
+    for (std::size_t c = 0; c <= n; ++c)
+      by_size[c + 1] += by_size[c];
+    for (std::size_t b = 0; b < n; ++b)
+      order[by_size[n - (start[b + 1] - start[b])]++] = b;
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      owner[i] = EMPTY;
+      disp[i] = 0;
+    }
+    for (std::size_t k = 0; k < n; ++k)
+    {
+      std::size_t b = order[k];
+      std::size_t count = start[b + 1] - start[b];
+      if (count == 0)
+        break;
+
+      std::uint32_t d = 0;
+      for (; d < max_disp; ++d)
+      {
+        std::size_t placed = 0;
+        for (; placed < count; ++placed)
+        {
+          std::size_t s = slot(hashes[members[start[b] + placed]], d, n);
+          if (owner[s] != EMPTY)
+            break;
+          owner[s] = static_cast<std::uint32_t>(members[start[b] + placed]);
+        }
+        if (placed == count)
+          break;
+        for (std::size_t p = 0; p < placed; ++p)
+          owner[slot(hashes[members[start[b] + p]], d, n)] = EMPTY;
+      }
+      if (d == max_disp)
+        return false;
+      disp[b] = d;
+    }
+    return true;
+  }
+};
+
+#endif
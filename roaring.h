@@ -0,0 +1,1178 @@
+#ifndef ROARING_H
+#define ROARING_H
+
+#include "set.h"
+
+#include <iostream>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+/**
+  @brief classe Set (BitmapStorage)
+
+  La classe implementa un Set di interi unici come bitmap compressa "roaring".
+  Lo spazio dei valori a 32 bit e' diviso in blocchi da 2^16 valori (i 16 bit alti del valore);
+  ogni blocco non vuoto e' un container che, a seconda della densita', e' un array ordinato,
+  una bitmap da 2^16 bit oppure una sequenza di run.
+
+  L'interfaccia e' la stessa di Set<int, Equals>, ma l'iterazione avviene in ordine crescente.
+  Il funtore Equals deve essere l'uguaglianza tra interi: i valori sono confrontati bit a bit
+  e il funtore non viene mai chiamato.
+*/
+template <typename Equals>
+class Set<int, Equals, BitmapStorage>
+{
+  static const unsigned int ARRAY_MAX = 4096;    ///< oltre questa cardinalita' un array diventa bitmap
+  static const unsigned int BITMAP_WORDS = 1024; ///< parole da 64 bit in una bitmap (2^16 bit)
+
+  /**
+    @brief Struttura container
+
+    Contiene i 16 bit bassi dei valori di un blocco. In base a type e' in uso uno solo dei vettori:
+    - ARRAY: valori ordinati, al piu' ARRAY_MAX elementi
+    - BITMAP: un bit per ogni valore possibile del blocco
+    - RUN: coppie (inizio, lunghezza - 1) ordinate, create solo da run_optimize()
+  */
+  struct container
+  {
+    enum kind
+    {
+      ARRAY,
+      BITMAP,
+      RUN
+    };
+
+    uint16_t key;                ///< 16 bit alti dei valori del container
+    kind type;                   ///< rappresentazione in uso
+    unsigned int card;           ///< numero di valori nel container
+    std::vector<uint16_t> array; ///< valori ordinati (ARRAY)
+    std::vector<uint64_t> bits;  ///< bitmap (BITMAP)
+    std::vector<uint16_t> runs;  ///< coppie (inizio, lunghezza - 1) (RUN)
+
+    /**
+      @brief Costruttore di default
+
+      @post container ARRAY vuoto con chiave 0
+    */
+    container() : key(0), type(ARRAY), card(0) {}
+
+    /**
+      @brief Costruttore secondario
+
+      @param k 16 bit alti dei valori del container
+
+      @post container ARRAY vuoto con chiave k
+    */
+    explicit container(uint16_t k) : key(k), type(ARRAY), card(0) {}
+
+    /**
+      @brief Verifica se un valore e' presente nel container
+
+      @param low 16 bit bassi del valore da cercare
+
+      @return true se il valore e' presente, false altrimenti
+    */
+    bool contains(uint16_t low) const
+    {
+      if (type == BITMAP)
+        return (bits[low >> 6] >> (low & 63)) & 1;
+      if (type == ARRAY)
+        return std::binary_search(array.begin(), array.end(), low);
+
+      // ultimo run che inizia prima di low
+      std::size_t lo = 0, hi = runs.size() / 2;
+      while (lo < hi)
+      {
+        std::size_t mid = (lo + hi) / 2;
+        if (runs[2 * mid] <= low)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+      if (lo == 0)
+        return false;
+      --lo;
+      return low - runs[2 * lo] <= runs[2 * lo + 1];
+    }
+
+    /**
+      @brief Aggiunge un valore al container
+
+      @param low 16 bit bassi del valore da aggiungere
+
+      @return true se il valore e' stato aggiunto, false se era gia' presente
+
+      @throw std::bad_alloc possibile eccezione di allocazione
+    */
+    bool add(uint16_t low)
+    {
+      if (type == RUN)
+      {
+        if (contains(low))
+          return false;
+        normalize();
+      }
+      if (type == BITMAP)
+      {
+        uint64_t mask = uint64_t(1) << (low & 63);
+        if (bits[low >> 6] & mask)
+          return false;
+        bits[low >> 6] |= mask;
+        ++card;
+        return true;
+      }
+
+      std::vector<uint16_t>::iterator it = std::lower_bound(array.begin(), array.end(), low);
+      if (it != array.end() && *it == low)
+        return false;
+      array.insert(it, low);
+      ++card;
+      if (card > ARRAY_MAX)
+        to_bitmap();
+      return true;
+    }
+
+    /**
+      @brief Rimuove un valore dal container
+
+      @param low 16 bit bassi del valore da rimuovere
+
+      @return true se il valore e' stato rimosso, false se non era presente
+    */
+    bool remove(uint16_t low)
+    {
+      if (type == RUN)
+      {
+        if (!contains(low))
+          return false;
+        normalize();
+      }
+      if (type == BITMAP)
+      {
+        uint64_t mask = uint64_t(1) << (low & 63);
+        if (!(bits[low >> 6] & mask))
+          return false;
+        bits[low >> 6] &= ~mask;
+        --card;
+        if (card <= ARRAY_MAX)
+          to_array();
+        return true;
+      }
+
+      std::vector<uint16_t>::iterator it = std::lower_bound(array.begin(), array.end(), low);
+      if (it == array.end() || *it != low)
+        return false;
+      array.erase(it);
+      --card;
+      return true;
+    }
+
+    /**
+      @brief Copia in out tutti i valori del container, in ordine crescente
+
+      @param out vettore di destinazione
+    */
+    void values(std::vector<uint16_t> &out) const
+    {
+      out.clear();
+      out.reserve(card);
+      if (type == ARRAY)
+        out = array;
+      else if (type == BITMAP)
+      {
+        for (unsigned int w = 0; w < BITMAP_WORDS; ++w)
+        {
+          uint64_t word = bits[w];
+          while (word != 0)
+          {
+            out.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+          }
+        }
+      }
+      else
+      {
+        for (std::size_t r = 0; r < runs.size(); r += 2)
+          for (unsigned int v = runs[r]; v <= unsigned(runs[r]) + runs[r + 1]; ++v)
+            out.push_back(static_cast<uint16_t>(v));
+      }
+    }
+
+    /**
+      @brief Converte un container ARRAY in BITMAP
+    */
+    void to_bitmap()
+    {
+      std::vector<uint64_t> tmp(BITMAP_WORDS, 0);
+      for (std::size_t i = 0; i < array.size(); ++i)
+        tmp[array[i] >> 6] |= uint64_t(1) << (array[i] & 63);
+      bits.swap(tmp);
+      std::vector<uint16_t>().swap(array);
+      type = BITMAP;
+    }
+
+    /**
+      @brief Converte un container BITMAP in ARRAY
+    */
+    void to_array()
+    {
+      std::vector<uint16_t> tmp;
+      values(tmp);
+      array.swap(tmp);
+      std::vector<uint64_t>().swap(bits);
+      type = ARRAY;
+    }
+
+    /**
+      @brief Converte un container RUN in ARRAY o BITMAP in base alla cardinalita'
+    */
+    void normalize()
+    {
+      if (type != RUN)
+        return;
+      std::vector<uint16_t> tmp;
+      values(tmp);
+      array.swap(tmp);
+      std::vector<uint16_t>().swap(runs);
+      type = ARRAY;
+      if (card > ARRAY_MAX)
+        to_bitmap();
+    }
+
+    /**
+      @brief Converte il container in RUN se occupa meno memoria
+
+      @return true se il container e' stato convertito, false altrimenti
+    */
+    bool optimize()
+    {
+      if (type == RUN)
+        return false;
+
+      std::vector<uint16_t> vals;
+      values(vals);
+      std::size_t nruns = 0;
+      for (std::size_t i = 0; i < vals.size(); ++i)
+        if (i == 0 || vals[i] != vals[i - 1] + 1)
+          ++nruns;
+      if (nruns * 2 * sizeof(uint16_t) >= bytes())
+        return false;
+
+      std::vector<uint16_t> tmp;
+      tmp.reserve(nruns * 2);
+      for (std::size_t i = 0; i < vals.size(); ++i)
+      {
+        if (i == 0 || vals[i] != vals[i - 1] + 1)
+        {
+          tmp.push_back(vals[i]);
+          tmp.push_back(0);
+        }
+        else
+          ++tmp.back();
+      }
+      runs.swap(tmp);
+      std::vector<uint16_t>().swap(array);
+      std::vector<uint64_t>().swap(bits);
+      type = RUN;
+      return true;
+    }
+
+    /**
+      @brief Memoria occupata dai valori del container
+
+      @return numero di byte usati dalla rappresentazione corrente
+    */
+    std::size_t bytes() const
+    {
+      if (type == ARRAY)
+        return array.size() * sizeof(uint16_t);
+      if (type == BITMAP)
+        return bits.size() * sizeof(uint64_t);
+      return runs.size() * sizeof(uint16_t);
+    }
+
+    /**
+      @brief Valore di rango rank nel container
+
+      @param rank posizione (0-based) del valore in ordine crescente, minore di card
+
+      @return 16 bit bassi del valore cercato
+    */
+    uint16_t select(unsigned int rank) const
+    {
+      if (type == ARRAY)
+        return array[rank];
+      if (type == BITMAP)
+      {
+        unsigned int w = 0;
+        while (rank >= unsigned(__builtin_popcountll(bits[w])))
+        {
+          rank -= __builtin_popcountll(bits[w]);
+          ++w;
+        }
+        uint64_t word = bits[w];
+        while (rank-- != 0)
+          word &= word - 1;
+        return static_cast<uint16_t>(w * 64 + __builtin_ctzll(word));
+      }
+      std::size_t r = 0;
+      while (rank > runs[r + 1])
+      {
+        rank -= runs[r + 1] + 1;
+        r += 2;
+      }
+      return static_cast<uint16_t>(runs[r] + rank);
+    }
+
+    /**
+      @brief Posiziona (pos, off) sul primo valore del container (non vuoto)
+    */
+    void first(unsigned int &pos, unsigned int &off) const
+    {
+      pos = (type == BITMAP) ? next_bit(0) : 0;
+      off = 0;
+    }
+
+    /**
+      @brief Sposta (pos, off) sul valore successivo
+
+      @return false se il container e' terminato, true altrimenti
+    */
+    bool advance(unsigned int &pos, unsigned int &off) const
+    {
+      if (type == ARRAY)
+        return ++pos < card;
+      if (type == BITMAP)
+      {
+        pos = next_bit(pos + 1);
+        return pos < BITMAP_WORDS * 64;
+      }
+      if (off < runs[2 * pos + 1])
+      {
+        ++off;
+        return true;
+      }
+      ++pos;
+      off = 0;
+      return 2 * pos < runs.size();
+    }
+
+    /**
+      @brief Valore in posizione (pos, off)
+
+      @return 16 bit bassi del valore
+    */
+    uint16_t at(unsigned int pos, unsigned int off) const
+    {
+      if (type == ARRAY)
+        return array[pos];
+      if (type == BITMAP)
+        return static_cast<uint16_t>(pos);
+      return static_cast<uint16_t>(runs[2 * pos] + off);
+    }
+
+    /**
+      @brief Primo bit a 1 a partire da from (BITMAP)
+
+      @return indice del bit, BITMAP_WORDS * 64 se non esiste
+    */
+    unsigned int next_bit(unsigned int from) const
+    {
+      unsigned int w = from >> 6;
+      if (w >= BITMAP_WORDS)
+        return BITMAP_WORDS * 64;
+      uint64_t word = bits[w] & (~uint64_t(0) << (from & 63));
+      while (word == 0)
+      {
+        if (++w == BITMAP_WORDS)
+          return BITMAP_WORDS * 64;
+        word = bits[w];
+      }
+      return w * 64 + __builtin_ctzll(word);
+    }
+
+    /**
+      @brief Operatore di confronto (uguaglianza) tra due container
+
+      @param other container da confrontare
+
+      @return true se i due container contengono gli stessi valori
+    */
+    bool operator==(const container &other) const
+    {
+      if (key != other.key || card != other.card)
+        return false;
+      if (type == other.type)
+      {
+        if (type == ARRAY)
+          return array == other.array;
+        if (type == BITMAP)
+          return bits == other.bits;
+        return runs == other.runs;
+      }
+      std::vector<uint16_t> a, b;
+      values(a);
+      other.values(b);
+      return a == b;
+    }
+
+    /**
+      @brief Unione di due container con la stessa chiave
+
+      @param a primo container
+      @param b secondo container
+      @param out container risultato (vuoto, con chiave gia' impostata)
+
+      @throw std::bad_alloc possibile eccezione di allocazione
+    */
+    static void unite(const container &a, const container &b, container &out)
+    {
+      if (a.type == RUN)
+      {
+        container tmp(a);
+        tmp.normalize();
+        unite(tmp, b, out);
+        return;
+      }
+      if (b.type == RUN)
+      {
+        container tmp(b);
+        tmp.normalize();
+        unite(a, tmp, out);
+        return;
+      }
+
+      if (a.type == BITMAP && b.type == BITMAP)
+      {
+        out.bits.resize(BITMAP_WORDS);
+        out.card = 0;
+        for (unsigned int w = 0; w < BITMAP_WORDS; ++w)
+        {
+          out.bits[w] = a.bits[w] | b.bits[w];
+          out.card += __builtin_popcountll(out.bits[w]);
+        }
+        out.type = BITMAP;
+      }
+      else if (a.type == BITMAP || b.type == BITMAP)
+      {
+        const container &bm = (a.type == BITMAP) ? a : b;
+        const container &ar = (a.type == BITMAP) ? b : a;
+        out.bits = bm.bits;
+        out.card = bm.card;
+        out.type = BITMAP;
+        for (std::size_t i = 0; i < ar.array.size(); ++i)
+        {
+          uint64_t mask = uint64_t(1) << (ar.array[i] & 63);
+          if (!(out.bits[ar.array[i] >> 6] & mask))
+          {
+            out.bits[ar.array[i] >> 6] |= mask;
+            ++out.card;
+          }
+        }
+      }
+      else
+      {
+        out.array.resize(a.card + b.card);
+        out.array.erase(std::set_union(a.array.begin(), a.array.end(),
+                                       b.array.begin(), b.array.end(),
+                                       out.array.begin()),
+                        out.array.end());
+        out.card = out.array.size();
+        out.type = ARRAY;
+        if (out.card > ARRAY_MAX)
+          out.to_bitmap();
+      }
+    }
+
+    /**
+      @brief Intersezione di due container con la stessa chiave
+
+      @param a primo container
+      @param b secondo container
+      @param out container risultato (vuoto, con chiave gia' impostata), eventualmente vuoto
+
+      @throw std::bad_alloc possibile eccezione di allocazione
+    */
+    static void intersect(const container &a, const container &b, container &out)
+    {
+      if (a.type == RUN)
+      {
+        container tmp(a);
+        tmp.normalize();
+        intersect(tmp, b, out);
+        return;
+      }
+      if (b.type == RUN)
+      {
+        container tmp(b);
+        tmp.normalize();
+        intersect(a, tmp, out);
+        return;
+      }
+
+      if (a.type == BITMAP && b.type == BITMAP)
+      {
+        out.bits.resize(BITMAP_WORDS);
+        out.card = 0;
+        for (unsigned int w = 0; w < BITMAP_WORDS; ++w)
+        {
+          out.bits[w] = a.bits[w] & b.bits[w];
+          out.card += __builtin_popcountll(out.bits[w]);
+        }
+        out.type = BITMAP;
+        if (out.card <= ARRAY_MAX)
+          out.to_array();
+      }
+      else if (a.type == BITMAP || b.type == BITMAP)
+      {
+        const container &bm = (a.type == BITMAP) ? a : b;
+        const container &ar = (a.type == BITMAP) ? b : a;
+        out.array.reserve(ar.card);
+        for (std::size_t i = 0; i < ar.array.size(); ++i)
+          if (bm.contains(ar.array[i]))
+            out.array.push_back(ar.array[i]);
+        out.card = out.array.size();
+        out.type = ARRAY;
+      }
+      else
+      {
+        out.array.resize(std::min(a.card, b.card));
+        out.array.erase(std::set_intersection(a.array.begin(), a.array.end(),
+                                              b.array.begin(), b.array.end(),
+                                              out.array.begin()),
+                        out.array.end());
+        out.card = out.array.size();
+        out.type = ARRAY;
+      }
+    }
+  };
+
+  /**
+    @brief Trasforma un int in un intero senza segno che ne preserva l'ordinamento
+
+    @param v valore da codificare
+
+    @return v con il bit di segno invertito
+  */
+  static uint32_t encode(int v)
+  {
+    return static_cast<uint32_t>(v) ^ 0x80000000u;
+  }
+
+  /**
+    @brief Inversa di encode
+
+    @param u valore codificato
+
+    @return int originale
+  */
+  static int decode(uint32_t u)
+  {
+    return static_cast<int>(u ^ 0x80000000u);
+  }
+
+  /**
+    @brief ricerca del container di una chiave
+
+    @param key 16 bit alti del valore cercato
+
+    @return indice del primo container con chiave >= key (_conts.size() se non esiste)
+  */
+  std::size_t find_container(uint16_t key) const
+  {
+    std::size_t lo = 0, hi = _conts.size();
+    while (lo < hi)
+    {
+      std::size_t mid = (lo + hi) / 2;
+      if (_conts[mid].key < key)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo;
+  }
+
+  std::vector<container> _conts; ///< container non vuoti, in ordine crescente di chiave
+  unsigned int _size;             ///< numero di elementi nel Set
+
+  template <typename E>
+  friend Set<int, E, BitmapStorage> operator+(const Set<int, E, BitmapStorage> &set1, const Set<int, E, BitmapStorage> &set2);
+
+  template <typename E>
+  friend Set<int, E, BitmapStorage> operator-(const Set<int, E, BitmapStorage> &set1, const Set<int, E, BitmapStorage> &set2);
+
+public:
+  /**
+    @brief Costruttore di default.
+
+    @post _size == 0
+  */
+  Set() : _size(0) {}
+
+  /**
+    @brief Copy constructor
+
+    @param other Set da copiare
+
+    @post Set chiamante contiene tutti e soli gli elementi di other.
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  Set(const Set &other) : _conts(other._conts), _size(other._size) {}
+
+  /**
+    @brief Costruttore con coppia di iteratori generici
+
+    @param beg iteratore all'inizio della sequenza
+    @param end iteratore alla fine della sequenza
+
+    @post Set chiamante contiene tutti e soli gli elementi della sequenza tra beg e end
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Q>
+  Set(Q beg, Q end) : _size(0)
+  {
+    SET_TRY
+    {
+      while (beg != end)
+      {
+        add(static_cast<int>(*beg));
+        ++beg;
+      }
+    }
+    SET_CATCH_ALL
+    {
+      clear();
+      SET_ALLOC_ERROR();
+    }
+  }
+
+  /**
+    @brief Operatore di assegnamento
+
+    @param other Set da copiare
+
+    @return reference al Set this
+
+    @post Set chiamante contiene tutti e soli gli elementi di other.
+  */
+  Set &operator=(const Set &other)
+  {
+    if (this != &other)
+    {
+      Set tmp(other);
+      _conts.swap(tmp._conts);
+      std::swap(_size, tmp._size);
+    }
+    return *this;
+  }
+
+  /**
+    @brief Distruttore
+  */
+  ~Set() {}
+
+  /**
+    @brief Svuota il Set
+
+    @post _size == 0
+  */
+  void clear()
+  {
+    std::vector<container>().swap(_conts);
+    _size = 0;
+  }
+
+  /**
+    @brief Numero di elementi nel Set
+
+    @return numero di elementi nel Set
+  */
+  unsigned int size() const
+  {
+    return _size;
+  }
+
+  /**
+     @brief Operatore di lettura dell'elemento in posizione index (in ordine crescente)
+
+     @param index indice dell'elemento da leggere
+
+     @return valore dell'elemento in posizione index
+
+     @throw myexcp::myexcp_domain_error se viene passato un Set vuoto
+     @throw myexcp::myexcp_out_of_range se viene passato un indice out of bounds
+   */
+  int operator[](int index) const
+  {
+    if (_size == 0)
+      SET_THROW(myexcp_domain_error("Empty Set"));
+    if (index < 0 || static_cast<unsigned int>(index) > _size - 1)
+      SET_THROW(myexcp_out_of_range("Index out of bounds"));
+
+    unsigned int rank = index;
+    std::size_t c = 0;
+    while (rank >= _conts[c].card)
+    {
+      rank -= _conts[c].card;
+      ++c;
+    }
+    return decode((uint32_t(_conts[c].key) << 16) | _conts[c].select(rank));
+  }
+
+  /**
+    @brief Operatore di confronto (uguaglianza) tra due Set
+
+    @param other Set da confrontare
+
+    @return true se other e il Set chiamante contengono gli stessi elementi
+  */
+  bool operator==(const Set &other) const
+  {
+    if (_size != other._size || _conts.size() != other._conts.size())
+      return false;
+    for (std::size_t c = 0; c < _conts.size(); ++c)
+      if (!(_conts[c] == other._conts[c]))
+        return false;
+    return true;
+  }
+
+  /**
+    @brief Aggiunge un elemento nel set assicurandosi che non sia gia' presente
+
+    @param val valore da inserire nel set
+
+    @post _size = _size+1 se val non era presente
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void add(const int &val)
+  {
+    uint32_t u = encode(val);
+    uint16_t key = static_cast<uint16_t>(u >> 16);
+    std::size_t c = find_container(key);
+
+    if (c == _conts.size() || _conts[c].key != key)
+    {
+      container tmp(key);
+      tmp.add(static_cast<uint16_t>(u));
+      _conts.insert(_conts.begin() + c, tmp);
+      ++_size;
+      return;
+    }
+    if (_conts[c].add(static_cast<uint16_t>(u)))
+      ++_size;
+  }
+
+  /**
+    @brief Rimuove (se presente) un elemento dal set.
+
+    @param val valore da rimuovere dal set
+
+    @post _size = _size-1 se val e' presente
+
+    @return true se val e' stato rimosso, false altrimenti
+  */
+  bool remove(const int &val)
+  {
+    uint32_t u = encode(val);
+    uint16_t key = static_cast<uint16_t>(u >> 16);
+    std::size_t c = find_container(key);
+
+    if (c == _conts.size() || _conts[c].key != key)
+      return false;
+    if (!_conts[c].remove(static_cast<uint16_t>(u)))
+      return false;
+    if (_conts[c].card == 0)
+      _conts.erase(_conts.begin() + c);
+    --_size;
+    return true;
+  }
+
+  /**
+    @brief ricerca di un valore nel Set
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool find(const int &val) const
+  {
+    uint32_t u = encode(val);
+    uint16_t key = static_cast<uint16_t>(u >> 16);
+    std::size_t c = find_container(key);
+
+    return c != _conts.size() && _conts[c].key == key &&
+           _conts[c].contains(static_cast<uint16_t>(u));
+  }
+
+  /**
+    @brief Sinonimo di find
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool contains(const int &val) const
+  {
+    return find(val);
+  }
+
+  /**
+    @brief Compatta i container che contengono lunghe sequenze di valori consecutivi
+
+    I container che occupano meno memoria come sequenza di run vengono convertiti.
+    Un container run torna array o bitmap alla prima modifica.
+
+    @return numero di container convertiti
+  */
+  unsigned int run_optimize()
+  {
+    unsigned int converted = 0;
+    for (std::size_t c = 0; c < _conts.size(); ++c)
+      if (_conts[c].optimize())
+        ++converted;
+    return converted;
+  }
+
+  /**
+    @brief Memoria occupata dal Set
+
+    @return numero di byte usati dai container e dai loro valori
+  */
+  std::size_t bytes_used() const
+  {
+    std::size_t total = _conts.capacity() * sizeof(container);
+    for (std::size_t c = 0; c < _conts.size(); ++c)
+      total += _conts[c].bytes();
+    return total;
+  }
+
+  /**
+    @brief stampa del Set nello standard output
+
+    Overloading dell'operatore << dello standard output per stampa del Set
+
+    @return ostream con il Set da stampare
+  */
+  friend std::ostream &operator<<(std::ostream &os, const Set &mset)
+  {
+    bool first = true;
+    os << "{";
+    for (const_iterator it = mset.begin(); it != mset.end(); ++it)
+    {
+      if (!first)
+        os << ", ";
+      first = false;
+      os << *it;
+    }
+    os << "}";
+    return os;
+  }
+
+  /**
+  @brief classe const_iterator
+
+  Classe interna di iteratori costanti (sola lettura) per iterare sul Set in ordine crescente
+
+  */
+  class const_iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef int val_type;
+    typedef ptrdiff_t difference_type;
+    typedef const int *pointer;
+    typedef const int &reference;
+
+    /**
+      @brief Costruttore di default.
+    */
+    const_iterator() : _conts(nullptr), _c(0), _pos(0), _off(0), _val(0) {}
+
+    /**
+      @brief Copy constructor
+
+      @param other iteratore da copiare
+    */
+    const_iterator(const const_iterator &other)
+        : _conts(other._conts), _c(other._c), _pos(other._pos), _off(other._off), _val(other._val) {}
+
+    /**
+      @brief Operatore di assegnamento
+
+      @param other iteratore da copiare
+
+      @return reference all'iteratore this
+    */
+    const_iterator &operator=(const const_iterator &other)
+    {
+      _conts = other._conts;
+      _c = other._c;
+      _pos = other._pos;
+      _off = other._off;
+      _val = other._val;
+      return *this;
+    }
+
+    /**
+      @brief Distruttore
+    */
+    ~const_iterator() {}
+
+    /**
+      @brief Operatore di dereferenziamento
+
+      @return reference al valore dell'elemento corrente
+
+      @throw myexcp::myexcp_domain_error se viene dereferenziato end()
+    */
+    reference operator*() const
+    {
+#if SET_ITERATOR_CHECKS
+      if (_conts == nullptr || _c >= _conts->size())
+        SET_THROW(myexcp_domain_error("Dereferencing end()"));
+#endif
+      return _val;
+    }
+
+    /**
+      @brief Operatore freccia
+
+      @return puntatore al valore dell'elemento corrente
+    */
+    pointer operator->() const
+    {
+      return &(operator*());
+    }
+
+    /**
+      @brief Operatore post incremento
+
+      @param int dummy parameter
+
+      @return reference all'iteratore this (prima di essere incrementato)
+
+      @throw myexcp::myexcp_domain_error se viene incrementato end()
+    */
+    const_iterator operator++(int)
+    {
+      const_iterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    /**
+      @brief Operatore pre incremento
+
+      @return reference all'iteratore this (incrementato)
+
+      @throw myexcp::myexcp_domain_error se viene incrementato end()
+    */
+    const_iterator &operator++()
+    {
+#if SET_ITERATOR_CHECKS
+      if (_conts == nullptr || _c >= _conts->size())
+        SET_THROW(myexcp_domain_error("Dereferencing end()"));
+#endif
+      if (!(*_conts)[_c].advance(_pos, _off))
+      {
+        ++_c;
+        _pos = 0;
+        _off = 0;
+        if (_c < _conts->size())
+          (*_conts)[_c].first(_pos, _off);
+      }
+      load();
+      return *this;
+    }
+
+    /**
+    @brief Operatore di confronto (uguaglianza) tra due iteratori
+
+    @param other iteratore da confrontare
+
+    @return true se i due iteratori puntano allo stesso elemento
+    */
+    bool operator==(const const_iterator &other) const
+    {
+      return _conts == other._conts && _c == other._c && _pos == other._pos && _off == other._off;
+    }
+
+    /**
+    @brief Operatore di confronto (disuguaglianza) tra due iteratori
+
+    @param other iteratore da confrontare
+
+    @return true se i due iteratori non puntano allo stesso elemento
+    */
+    bool operator!=(const const_iterator &other) const
+    {
+      return !(*this == other);
+    }
+
+  private:
+    const std::vector<container> *_conts; ///< container del Set
+    std::size_t _c;                       ///< container corrente
+    unsigned int _pos;                    ///< posizione nel container corrente
+    unsigned int _off;                    ///< offset nel run corrente (solo RUN)
+    int _val;                             ///< valore corrente, decodificato
+
+    friend class Set;
+
+    const_iterator(const std::vector<container> *conts, std::size_t c)
+        : _conts(conts), _c(c), _pos(0), _off(0), _val(0)
+    {
+      if (_c < _conts->size())
+        (*_conts)[_c].first(_pos, _off);
+      load();
+    }
+
+    void load()
+    {
+      if (_c < _conts->size())
+        _val = decode((uint32_t((*_conts)[_c].key) << 16) | (*_conts)[_c].at(_pos, _off));
+    }
+  };
+
+  /**
+      @brief Iteratore all'inizio del Set
+
+      @return copia dell'iteratore al valore minimo del Set
+  */
+  const_iterator begin() const
+  {
+    return const_iterator(&_conts, 0);
+  }
+
+  /**
+      @brief Iteratore alla fine del Set
+
+      @return copia dell'iteratore alla fine del Set
+  */
+  const_iterator end() const
+  {
+    return const_iterator(&_conts, _conts.size());
+  }
+};
+
+/**
+  @brief Set di interi a bitmap compressa
+
+  Nome storico di Set<int, Equals, BitmapStorage>.
+*/
+template <typename Equals>
+using RoaringSet = Set<int, Equals, BitmapStorage>;
+
+/**
+    @brief Crea un nuovo Set con tutti e soli gli elementi del Set di partenza che soddisfano un certo predicato
+
+    @param mset Set di partenza
+    @param pred predicato booleano filtro
+
+    @return Set con tutti e soli gli elementi del Set di partenza che soddisfano il predicato P
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename E, typename P>
+Set<int, E, BitmapStorage> filter_out(const Set<int, E, BitmapStorage> &mset, P pred)
+{
+  Set<int, E, BitmapStorage> out_set;
+  typename Set<int, E, BitmapStorage>::const_iterator beg = mset.begin(),
+                                         end = mset.end();
+
+  SET_TRY
+  {
+    // valori in ordine crescente: ogni add lavora sull'ultimo container
+    while (beg != end)
+    {
+      if (pred(*beg))
+        out_set.add(*beg);
+      ++beg;
+    }
+  }
+  SET_CATCH_ALL
+  {
+    SET_ALLOC_ERROR();
+  }
+  return out_set;
+}
+
+/**
+    @brief Unione di due Set, container per container (OR)
+
+    @param set1 primo Set da unire
+    @param set2 secondo Set da unire
+
+    @return Set che contiene gli elementi di entrambi i Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename E>
+Set<int, E, BitmapStorage> operator+(const Set<int, E, BitmapStorage> &set1, const Set<int, E, BitmapStorage> &set2)
+{
+  typedef typename Set<int, E, BitmapStorage>::container container;
+
+  Set<int, E, BitmapStorage> out_set;
+  std::size_t i = 0, j = 0;
+  const std::size_t n1 = set1._conts.size(), n2 = set2._conts.size();
+
+  out_set._conts.reserve(std::max(n1, n2));
+  while (i < n1 || j < n2)
+  {
+    if (j == n2 || (i < n1 && set1._conts[i].key < set2._conts[j].key))
+      out_set._conts.push_back(set1._conts[i++]);
+    else if (i == n1 || set2._conts[j].key < set1._conts[i].key)
+      out_set._conts.push_back(set2._conts[j++]);
+    else
+    {
+      out_set._conts.push_back(container(set1._conts[i].key));
+      container::unite(set1._conts[i++], set2._conts[j++], out_set._conts.back());
+    }
+    out_set._size += out_set._conts.back().card;
+  }
+  return out_set;
+}
+
+/**
+    @brief Intersezione di due Set, container per container (AND)
+
+    @param set1 primo Set da intersecare
+    @param set2 secondo Set da intersecare
+
+    @return Set che contiene gli elementi comuni ad entrambi i Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename E>
+Set<int, E, BitmapStorage> operator-(const Set<int, E, BitmapStorage> &set1, const Set<int, E, BitmapStorage> &set2)
+{
+  typedef typename Set<int, E, BitmapStorage>::container container;
+
+  Set<int, E, BitmapStorage> out_set;
+  std::size_t i = 0, j = 0;
+  const std::size_t n1 = set1._conts.size(), n2 = set2._conts.size();
+
+  while (i < n1 && j < n2)
+  {
+    if (set1._conts[i].key < set2._conts[j].key)
+      ++i;
+    else if (set2._conts[j].key < set1._conts[i].key)
+      ++j;
+    else
+    {
+      container tmp(set1._conts[i].key);
+      container::intersect(set1._conts[i++], set2._conts[j++], tmp);
+      if (tmp.card != 0)
+      {
+        out_set._conts.push_back(tmp);
+        out_set._size += tmp.card;
+      }
+    }
+  }
+  return out_set;
+}
+
+#endif
@@ -2,27 +2,53 @@
 #define SET_H
 
 #include "myexcp.h"
+#include "storage.h"
+#include "batch_table.h"
+#include "changelog.h"
 
 #include <iostream>
 #include <iterator>
 #include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 /**
-  @brief classe Set
+  @brief Politica di riorganizzazione della lista dopo una ricerca riuscita
 
-  La classe implementa un Set di elementi generici T unici (senza ripetizione).
+  Con chiavi cercate con frequenze molto diverse, spostare in avanti gli elementi trovati
+  accorcia la scansione media di find.
+*/
+enum reorder_policy
+{
+  REORDER_NONE,          ///< la lista non viene riordinata
+  REORDER_MOVE_TO_FRONT, ///< l'elemento trovato viene spostato in testa
+  REORDER_TRANSPOSE,     ///< l'elemento trovato viene scambiato con il precedente
+  REORDER_COUNT          ///< l'elemento trovato avanza prima degli elementi trovati meno volte
+};
+
+/**
+  @brief classe Set (ListStorage)
+
+  La classe implementa un Set di elementi generici T unici (senza ripetizione) come lista concatenata.
   Il funtore Equals serve a comparare due elementi a e b di tipo T, e restituisce true se sono uguali.
+  E' lo storage di default di Set (vedi storage.h).
 
 */
 template <typename T, typename Equals>
-class Set
+class Set<T, Equals, ListStorage>
 {
+  typedef typename std::remove_cv<T>::type value_type;
 
   /**
     @brief Struttura node
 
     Struttura dati node interna che viene usata per creare il Set.
-    Ogni nodo ha un valore (val) e un puntatore al nodo successivo (next).
+    Ogni nodo ha un valore (val) e un puntatore al nodo successivo (next). Il numero di ricerche
+    riuscite usato da REORDER_COUNT e' tenuto fuori dal nodo, in _hits.
   */
   struct node
   {
@@ -89,7 +115,8 @@ class Set
 
     @return puntatore al nodo precedente del nodo trovato, nullptr se non esiste (o se e' la testa, la gestione spetta al chiamante)
   */
-  node *find_internal(const T &val) const
+  template <typename K>
+  node *find_internal(const K &val) const
   {
     node *curr = _head;
     node *prev = _head;
@@ -105,9 +132,369 @@ class Set
     return nullptr;
   }
 
-  node *_head;        ///< puntatore al primo elemento del Set
-  unsigned int _size; ///< numero di elementi nel Set
-  Equals _equals;     ///< funtore per il confronto di eguaglianza tra dati T
+  /**
+    @brief ricerca di una chiave con riorganizzazione della lista secondo _policy
+
+    @param val chiave da cercare, confrontata con Equals(T, K)
+
+    @return puntatore al nodo trovato (dopo lo spostamento), nullptr se non esiste
+  */
+  template <typename K>
+  node *find_reorder(const K &val)
+  {
+    node *pprev = nullptr;
+    node *prev = nullptr;
+    node *curr = _head;
+
+    while (curr != nullptr && !_equals(curr->val, val))
+    {
+      pprev = prev;
+      prev = curr;
+      curr = curr->next;
+    }
+    if (curr == nullptr)
+      return nullptr;
+
+    unsigned int hits = 0;
+    if (_policy == REORDER_COUNT)
+    {
+      unsigned int &count = _hits.find(curr)->second;
+      if (count != static_cast<unsigned int>(-1))
+        ++count;
+      hits = count;
+    }
+    if (prev == nullptr)
+      return curr;
+
+    switch (_policy)
+    {
+    case REORDER_MOVE_TO_FRONT:
+      prev->next = curr->next;
+      curr->next = _head;
+      _head = curr;
+      break;
+    case REORDER_TRANSPOSE:
+      prev->next = curr->next;
+      curr->next = prev;
+      if (pprev == nullptr)
+        _head = curr;
+      else
+        pprev->next = curr;
+      break;
+    case REORDER_COUNT:
+    {
+      // primo nodo trovato meno volte di curr: curr viene inserito prima di lui
+      node *before = nullptr;
+      node *p = _head;
+      while (p != curr && _hits.find(p)->second >= hits)
+      {
+        before = p;
+        p = p->next;
+      }
+      if (p == curr)
+        break;
+      prev->next = curr->next;
+      curr->next = p;
+      if (before == nullptr)
+        _head = curr;
+      else
+        before->next = curr;
+      break;
+    }
+    default:
+      break;
+    }
+    return curr;
+  }
+
+  /**
+    @brief Rimuove (se presente) l'elemento uguale a key
+
+    @param val chiave da rimuovere, confrontata con Equals(T, K)
+
+    @return true se un elemento e' stato rimosso, false altrimenti
+  */
+  template <typename K>
+  bool remove_key(const K &val)
+  {
+    if (_size == 0)
+      return false;
+
+    // per come e' implementata find_internal(), mi devo assicurare che il valore da cancellare non sia in _head
+    if (_equals(_head->val, val))
+    {
+      node *tmp = _head;
+      record(CHANGE_REMOVE, tmp->val);
+      _head = tmp->next;
+      destroy_node(tmp);
+      tmp = nullptr; ///< per sicurezza
+      --_size;
+      invalidate();
+      return true;
+    }
+
+    node *prev = find_internal(val);
+    // find non ha trovato elemento con valore val
+    if (prev == nullptr)
+      return false;
+
+    node *culprit = prev->next;
+
+    record(CHANGE_REMOVE, culprit->val);
+    prev->next = culprit->next;
+    destroy_node(culprit);
+    culprit = nullptr; ///< per sicurezza
+    --_size;
+    invalidate();
+    return true;
+  }
+
+  /**
+    @brief ricerca di una chiave nel Set
+
+    @param val chiave da cercare, confrontata con Equals(T, K)
+
+    @return true se un elemento uguale a val e' presente nel Set, false altrimenti
+  */
+  template <typename K>
+  bool find_key(const K &val) const
+  {
+    if (_size == 0)
+      return false;
+    // per come e' implementata find_internal(), mi devo assicurare che il valore da trovare non sia in _head
+    if (_equals(_head->val, val))
+      return true;
+    return find_internal(val) != nullptr;
+  }
+
+  /**
+    @brief Verifica se un nodo appartiene ad un blocco preallocato
+
+    @param p nodo da controllare
+
+    @return true se p e' stato allocato da reserve() o insert(), false se con new
+  */
+  bool in_block(const node *p) const
+  {
+    std::size_t lo = 0, hi = _blocks.size();
+    std::less<const node *> before;
+
+    // ultimo blocco che inizia non dopo p
+    while (lo < hi)
+    {
+      std::size_t mid = (lo + hi) / 2;
+      if (before(p, _blocks[mid].first))
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+    return lo != 0 && before(p, _blocks[lo - 1].first + _blocks[lo - 1].second);
+  }
+
+  /**
+    @brief Crea un nodo, usando se possibile un nodo preallocato libero
+
+    @param val valore da copiare nel nodo
+
+    @return puntatore al nuovo nodo (next == nullptr), con 0 ricerche se _policy == REORDER_COUNT
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  node *create_node(const T &val)
+  {
+    node *slot = _free;
+    if (slot == nullptr)
+      slot = new node(val);
+    else
+    {
+      // il nodo viene tolto dalla lista libera prima della costruzione, che ne sovrascrive il link
+      _free = *reinterpret_cast<node **>(slot);
+      --_spare;
+      SET_TRY
+      {
+        new (static_cast<void *>(slot)) node(val);
+      }
+      SET_CATCH_ALL
+      {
+        new (static_cast<void *>(slot)) node *(_free);
+        _free = slot;
+        ++_spare;
+        SET_RETHROW();
+      }
+    }
+
+    if (_policy == REORDER_COUNT)
+    {
+      SET_TRY
+      {
+        _hits.emplace(slot, 0u);
+      }
+      SET_CATCH_ALL
+      {
+        destroy_node(slot);
+        SET_RETHROW();
+      }
+    }
+    return slot;
+  }
+
+  /**
+    @brief Distrugge un nodo; se appartiene ad un blocco preallocato lo rende di nuovo disponibile
+
+    @param p nodo da distruggere
+  */
+  void destroy_node(node *p)
+  {
+    if (!_hits.empty())
+      _hits.erase(p);
+    if (_blocks.empty() || !in_block(p))
+    {
+      delete p;
+      return;
+    }
+    p->~node();
+    new (static_cast<void *>(p)) node *(_free);
+    _free = p;
+    ++_spare;
+  }
+
+  /**
+    @brief Alloca un blocco contiguo di nodi liberi
+
+    @param count numero di nodi del blocco
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void allocate_block(std::size_t count)
+  {
+    node *block = static_cast<node *>(::operator new(count * sizeof(node)));
+    std::less<const node *> before;
+    std::size_t pos = _blocks.size();
+
+    while (pos != 0 && before(block, _blocks[pos - 1].first))
+      --pos;
+    SET_TRY
+    {
+      _blocks.insert(_blocks.begin() + pos, std::make_pair(block, count));
+    }
+    SET_CATCH_ALL
+    {
+      ::operator delete(block);
+      SET_RETHROW();
+    }
+
+    // i nodi vengono usati in ordine di indirizzo
+    for (std::size_t i = count; i != 0; --i)
+    {
+      new (static_cast<void *>(block + i - 1)) node *(_free);
+      _free = block + i - 1;
+    }
+    _spare += count;
+  }
+
+  /**
+    @brief Segnala che gli iteratori esistenti possono riferirsi a nodi distrutti
+
+    Con SET_ITERATOR_CHECKS >= 2 gli iteratori creati prima della chiamata lanciano un'eccezione.
+  */
+  void invalidate()
+  {
+#if SET_ITERATOR_CHECKS >= 2
+    ++_generation;
+#endif
+  }
+
+  /**
+    @brief Registra una modifica effettiva nel change log (se attivo)
+
+    Va chiamata prima di collegare o scollegare il nodo: se la registrazione lancia un'eccezione
+    il Set non viene modificato.
+
+    @param kind tipo di modifica
+    @param val elemento aggiunto o rimosso
+  */
+  void record(change_kind kind, const T &val)
+  {
+    if (_log != nullptr)
+      _log->record(kind, val);
+  }
+
+  /**
+    @brief Registra nel change log (se attivo) la sostituzione del contenuto con quello di other
+
+    Le modifiche vengono copiate in un blocco e registrate insieme: se una copia lancia
+    un'eccezione ne' il log ne' i suoi osservatori vedono una parte della sostituzione.
+
+    @param other Set che prendera' il posto del contenuto attuale (nullptr = svuotamento)
+
+    @throw eccezione del costruttore di copia di T (il Set non va modificato)
+  */
+  void record_replace(const Set *other)
+  {
+    if (_log == nullptr)
+      return;
+
+    std::vector<set_change<value_type> > batch;
+    batch.reserve(_size + (other != nullptr ? other->_size : 0));
+    for (node *curr = _head; curr != nullptr; curr = curr->next)
+      batch.push_back(set_change<value_type>(0, CHANGE_REMOVE, curr->val));
+    for (node *curr = other != nullptr ? other->_head : nullptr; curr != nullptr; curr = curr->next)
+      batch.push_back(set_change<value_type>(0, CHANGE_ADD, curr->val));
+    _log->record_all(batch);
+  }
+
+  /**
+    @brief Registra l'aggiunta e collega un nuovo nodo in testa alla lista
+
+    @param tmp nodo da collegare (distrutto se la registrazione lancia un'eccezione)
+
+    @post _size = _size+1
+  */
+  void push_front(node *tmp)
+  {
+    SET_TRY
+    {
+      record(CHANGE_ADD, tmp->val);
+    }
+    SET_CATCH_ALL
+    {
+      destroy_node(tmp);
+      SET_RETHROW();
+    }
+    tmp->next = _head;
+    _head = tmp;
+    ++_size;
+  }
+
+  /**
+    @brief Scambia il contenuto di due Set
+
+    @param other Set con cui scambiare elementi e nodi preallocati
+  */
+  void swap(Set &other)
+  {
+    std::swap(_head, other._head);
+    std::swap(_size, other._size);
+    std::swap(_policy, other._policy);
+    _hits.swap(other._hits);
+    invalidate();
+    other.invalidate();
+    std::swap(_free, other._free);
+    std::swap(_spare, other._spare);
+    _blocks.swap(other._blocks);
+  }
+
+  node *_head;               ///< puntatore al primo elemento del Set
+  unsigned int _size;        ///< numero di elementi nel Set
+  Equals _equals;            ///< funtore per il confronto di eguaglianza tra dati T
+  reorder_policy _policy;    ///< politica di riorganizzazione dopo le ricerche riuscite
+  std::unordered_map<const node *, unsigned int> _hits; ///< ricerche riuscite per nodo (solo con REORDER_COUNT)
+  unsigned long _generation; ///< incrementato quando dei nodi vengono distrutti (SET_ITERATOR_CHECKS >= 2)
+  change_log<value_type> *_log; ///< modifiche effettive, nullptr se il change log non e' attivo
+
+  node *_free;                                          ///< nodi preallocati liberi
+  unsigned int _spare;                                  ///< numero di nodi preallocati liberi
+  std::vector<std::pair<node *, std::size_t> > _blocks; ///< blocchi preallocati (inizio, nodi), per indirizzo
 
 public:
   /**
@@ -116,7 +503,7 @@ public:
     @post _head == nullptr
     @post _size == 0
   */
-  Set() : _head(nullptr), _size(0) {}
+  Set() : _head(nullptr), _size(0), _policy(REORDER_NONE), _generation(0), _log(nullptr), _free(nullptr), _spare(0) {}
 
   /**
     @brief Copy constructor
@@ -127,24 +514,29 @@ public:
     @post Set chiamante contiene tutti e soli gli elementi di other.
     @throw std::bad_alloc possibile eccezione di allocazione
   */
-  Set(const Set &other) : _head(nullptr), _size(0)
+  Set(const Set &other) : _head(nullptr), _size(0), _policy(REORDER_NONE), _generation(0), _log(nullptr), _free(nullptr), _spare(0)
   {
     node *curr = other._head;
 
-    try
+    _policy = other._policy;
+    SET_TRY
     {
       clear();
+      // gli elementi di other sono gia' distinti: niente ricerche, stesso ordine di una sequenza di add
+      reserve(other._size);
       while (curr != nullptr)
       {
-        add(curr->val);
+        node *tmp = create_node(curr->val);
+        tmp->next = _head;
+        _head = tmp;
+        ++_size;
         curr = curr->next;
       }
     }
-    catch (...)
+    SET_CATCH_ALL
     {
       clear();
-      std::cerr << ("   %%%   ERROR IN MEMORY ALLOCATION   %%%");
-      throw;
+      SET_ALLOC_ERROR();
     }
   }
 
@@ -159,9 +551,9 @@ public:
     @throw std::bad_alloc possibile eccezione di allocazione
   */
   template <typename Q>
-  Set(Q beg, Q end) : _head(nullptr), _size(0)
+  Set(Q beg, Q end) : _head(nullptr), _size(0), _policy(REORDER_NONE), _generation(0), _log(nullptr), _free(nullptr), _spare(0)
   {
-    try
+    SET_TRY
     {
       clear();
       while (beg != end)
@@ -170,11 +562,10 @@ public:
         ++beg;
       }
     }
-    catch (...)
+    SET_CATCH_ALL
     {
       clear();
-      std::cerr << ("   %%%   ERROR IN MEMORY ALLOCATION   %%%");
-      throw;
+      SET_ALLOC_ERROR();
     }
   }
 
@@ -193,8 +584,9 @@ public:
     if (this != &other)
     {
       Set tmp(other);
-      std::swap(this->_head, tmp._head);
-      std::swap(this->_size, tmp._size);
+      // il change log resta a this: registra la sostituzione come rimozioni e aggiunte
+      record_replace(&tmp);
+      swap(tmp);
     }
     return *this;
   }
@@ -207,6 +599,10 @@ public:
   */
   ~Set()
   {
+    if (_log != nullptr)
+      _log->detach(true);
+    delete _log;
+    _log = nullptr;
     clear();
   }
 
@@ -215,19 +611,140 @@ public:
 
     @post _head == nullptr
     @post _size == 0
+
+    @throw eccezione del costruttore di copia di T se il change log e' attivo (Set non modificato)
   */
   void clear()
   {
+    record_replace(nullptr);
+
     node *curr = _head;
 
     while (curr != nullptr)
     {
       node *next = curr->next;
-      delete curr;
+      if (_blocks.empty() || !in_block(curr))
+        delete curr;
+      else
+        curr->~node();
       curr = next;
     }
     _size = 0;
     _head = nullptr;
+    _hits.clear();
+    invalidate();
+
+    for (std::size_t b = 0; b < _blocks.size(); ++b)
+      ::operator delete(_blocks[b].first);
+    _blocks.clear();
+    _free = nullptr;
+    _spare = 0;
+  }
+
+  /**
+    @brief Numero di elementi nel Set
+
+    @return numero di elementi nel Set
+  */
+  unsigned int size() const
+  {
+    return _size;
+  }
+
+  /**
+    @brief Imposta la politica di riorganizzazione della lista
+
+    Con una politica diversa da REORDER_NONE find_and_promote e add di un elemento gia' presente
+    spostano in avanti l'elemento trovato (gli iteratori restano validi ma l'ordine cambia).
+    find e contains sono const e non riordinano mai la lista.
+
+    @param policy nuova politica
+
+    @throw std::bad_alloc possibile eccezione di allocazione (passando a REORDER_COUNT)
+  */
+  void set_reorder(reorder_policy policy)
+  {
+    if (policy == REORDER_COUNT && _policy != REORDER_COUNT)
+    {
+      // i contatori partono da 0 per tutti i nodi gia' presenti
+      std::unordered_map<const node *, unsigned int> hits;
+      hits.reserve(_size);
+      for (node *curr = _head; curr != nullptr; curr = curr->next)
+        hits.emplace(curr, 0u);
+      _hits.swap(hits);
+    }
+    else if (policy != REORDER_COUNT)
+      std::unordered_map<const node *, unsigned int>().swap(_hits);
+    _policy = policy;
+  }
+
+  /**
+    @brief Politica di riorganizzazione corrente
+
+    @return politica di riorganizzazione della lista
+  */
+  reorder_policy reorder() const
+  {
+    return _policy;
+  }
+
+  /**
+    @brief Attiva, ridimensiona o disattiva il change log
+
+    Con il change log attivo ogni add e remove effettiva (non quelle di duplicati o di elementi
+    assenti) viene registrata con un numero di sequenza; clear e l'assegnamento registrano una
+    rimozione per ogni elemento. Le copie di un Set non ereditano il change log. Attivarlo o
+    ridimensionarlo azzera la storia e riparte dal numero di sequenza 1; gli osservatori del
+    change log precedente vengono avvisati (change_listener::on_detach).
+
+    @param capacity numero massimo di modifiche conservate (0 = change log disattivato)
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void set_change_log(std::size_t capacity)
+  {
+    change_log<value_type> *log = capacity != 0 ? new change_log<value_type>(capacity) : nullptr;
+    if (_log != nullptr)
+      _log->detach(false);
+    delete _log;
+    _log = log;
+  }
+
+  /**
+    @brief Change log del Set
+
+    @return change log, nullptr se non e' attivo
+  */
+  const change_log<value_type> *changes() const
+  {
+    return _log;
+  }
+
+  /**
+    @brief Change log del Set, per registrare degli osservatori
+
+    @return change log, nullptr se non e' attivo
+  */
+  change_log<value_type> *changes()
+  {
+    return _log;
+  }
+
+  /**
+    @brief Modifiche effettive successive ad un numero di sequenza
+
+    @param since ultimo numero di sequenza gia' letto (0 = nessuno)
+    @param out vettore a cui vengono accodate le modifiche, in ordine di sequenza
+
+    @return true se out contiene tutte le modifiche successive a since, false se alcune sono
+            state sovrascritte, since e' successivo all'ultima modifica del log corrente o il
+            change log non e' attivo (il consumatore deve rileggere il Set)
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  bool changes_since(unsigned long long since, std::vector<set_change<value_type> > &out) const
+  {
+    return _log != nullptr && _log->changes_since(since, out);
   }
 
   /**
@@ -243,9 +760,9 @@ public:
   const T &operator[](int index) const
   {
     if (_size == 0)
-      throw(myexcp_domain_error("Empty Set"));
+      SET_THROW(myexcp_domain_error("Empty Set"));
     if (index < 0 || index > _size - 1)
-      throw(myexcp_out_of_range("Index out of bounds"));
+      SET_THROW(myexcp_out_of_range("Index out of bounds"));
 
     node *curr = _head;
     while (index != 0)
@@ -256,6 +773,27 @@ public:
     return curr->val;
   }
 
+  /**
+     @brief Lettura dell'elemento in posizione index senza eccezioni
+
+     @param index indice dell'elemento da leggere
+
+     @return puntatore all'elemento in posizione index, nullptr se il Set e' vuoto o l'indice e' out of bounds
+   */
+  const T *try_at(int index) const
+  {
+    if (index < 0 || static_cast<unsigned int>(index) >= _size)
+      return nullptr;
+
+    node *curr = _head;
+    while (index != 0)
+    {
+      curr = curr->next;
+      --index;
+    }
+    return &(curr->val);
+  }
+
   /**
     @brief Operatore di confronto (uguaglianza) tra due Set
 
@@ -299,37 +837,168 @@ public:
   */
   void add(const T &val)
   {
-    node *tmp = new node(val);
+    node *tmp = create_node(val);
 
     if (_size == 0)
     {
-      _head = tmp;
-      _size = 1;
+      push_front(tmp);
       return;
     }
 
+    // con una politica di riorganizzazione anche la add di un elemento gia' presente conta come ricerca
+    if (_policy != REORDER_NONE)
+    {
+      if (find_reorder(val) != nullptr)
+      {
+        destroy_node(tmp);
+        tmp = nullptr; ///< per sicurezza
+        return;
+      }
+    }
     // per come e' implementata find_internal, devo essere sicuro che _head non sia uguale a val
-    if (_equals(_head->val, val))
+    else if (_equals(_head->val, val) || find_internal(val) != nullptr)
     {
-      delete tmp;
+      destroy_node(tmp);
       tmp = nullptr; ///< per sicurezza
       return;
     }
 
-    node *prev = find_internal(val);
+    push_front(tmp);
+    return;
+  }
+
+  /**
+    @brief Aggiunge un elemento nel set senza eccezioni
+
+    Se non ci sono nodi preallocati liberi il nodo viene allocato con new (std::nothrow).
+
+    @param val valore da inserire nel set
 
-    // find ha trovato elemento con valore val
-    if (prev != nullptr)
+    @return SET_OK se val e' stato aggiunto, SET_EXISTS se era gia' presente,
+            SET_NO_MEMORY se l'allocazione e' fallita (il Set non viene modificato)
+  */
+  set_status try_add(const T &val)
+  {
+    if (find_key(val))
+      return SET_EXISTS;
+
+    node *tmp = nullptr;
+    if (_free != nullptr)
+      tmp = create_node(val);
+    else
     {
-      delete tmp;
-      tmp = nullptr; ///< per sicurezza
-      return;
+      tmp = new (std::nothrow) node(val);
+      if (tmp == nullptr)
+        return SET_NO_MEMORY;
     }
 
+    SET_TRY
+    {
+      record(CHANGE_ADD, tmp->val);
+    }
+    SET_CATCH_ALL
+    {
+      destroy_node(tmp);
+      return SET_NO_MEMORY;
+    }
     tmp->next = _head;
     _head = tmp;
     ++_size;
-    return;
+    return SET_OK;
+  }
+
+  /**
+    @brief Prealloca in un unico blocco i nodi necessari a contenere n elementi
+
+    I nodi preallocati vengono usati dalle add e dalle insert successive; i nodi di un blocco
+    rimossi tornano disponibili e la memoria dei blocchi viene liberata solo da clear().
+
+    @param n numero di elementi che il Set deve poter contenere senza ulteriori allocazioni
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void reserve(unsigned int n)
+  {
+    if (n > _size + _spare)
+      allocate_block(n - _size - _spare);
+  }
+
+  /**
+    @brief Aggiunge al Set tutti gli elementi di una sequenza
+
+    Equivale a chiamare add su ogni elemento della sequenza, ma i duplicati (interni alla
+    sequenza e rispetto al contenuto del Set) vengono scartati con una tabella hash costruita
+    sulla sequenza e una sola passata sul Set; i nuovi nodi sono allocati in un unico blocco.
+
+    Il funtore Hash deve essere coerente con Equals: se Equals(a, b) allora Hash(a) == Hash(b).
+
+    @param first iteratore all'inizio della sequenza
+    @param last iteratore alla fine della sequenza
+    @param hash funtore di hash sui dati T
+
+    @return numero di elementi effettivamente aggiunti
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Iter, typename Hash = std::hash<typename std::remove_cv<T>::type> >
+  unsigned int insert(Iter first, Iter last, Hash hash = Hash())
+  {
+    batch_table<T, Equals, Hash> batch(first, last, hash);
+    const std::size_t k = batch.vals.size();
+    std::vector<char> keep(k, 0);
+
+    // duplicati interni alla sequenza: resta la prima occorrenza
+    for (std::size_t i = 0; i < k; ++i)
+      keep[i] = (batch.insert(i) == i);
+
+    // duplicati rispetto al Set: una sola passata sulla lista
+    for (node *curr = _head; curr != nullptr; curr = curr->next)
+    {
+      std::size_t j = batch.find(curr->val, hash(curr->val));
+      if (j != k)
+        keep[j] = 0;
+    }
+
+    unsigned int added = 0;
+    for (std::size_t i = 0; i < k; ++i)
+      added += keep[i];
+    reserve(_size + added);
+
+    for (std::size_t i = 0; i < k; ++i)
+    {
+      if (!keep[i])
+        continue;
+      push_front(create_node(batch.vals[i]));
+    }
+    return added;
+  }
+
+  /**
+    @brief Aggiunge al Set una sequenza di elementi senza controllare i duplicati
+
+    Precondizione: gli elementi della sequenza sono distinti tra loro e non sono presenti nel Set
+    (es. un Set appena letto da un file scritto da write_set). I nuovi nodi sono allocati in un
+    unico blocco; l'ordine e' quello che si otterrebbe con add.
+
+    @param first iteratore all'inizio della sequenza (forward)
+    @param last iteratore alla fine della sequenza
+
+    @return numero di elementi aggiunti
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Iter>
+  unsigned int insert_unique(Iter first, Iter last)
+  {
+    unsigned int added = static_cast<unsigned int>(std::distance(first, last));
+    reserve(_size + added);
+
+    while (first != last)
+    {
+      push_front(create_node(static_cast<T>(*first)));
+      ++first;
+    }
+    return added;
   }
 
   /**
@@ -346,33 +1015,108 @@ public:
   */
   bool remove(const T &val)
   {
+    return remove_key(val);
+  }
 
-    if (_size == 0)
-      return false;
+  /**
+    @brief Rimuove (se presente) l'elemento uguale ad una chiave di tipo qualsiasi
 
-    // per come e' implementata find_internal(), mi devo assicurare che il valore da cancellare non sia in _head
-    if (_equals(_head->val, val))
+    Disponibile solo se Equals e' trasparente (definisce is_transparent) e sa confrontare
+    un T con un K: la chiave non viene convertita in T.
+
+    @param key chiave da rimuovere dal set
+
+    @return true se un elemento e' stato rimosso, false altrimenti
+  */
+  template <typename K, typename E = Equals, typename = typename E::is_transparent>
+  bool remove(const K &key)
+  {
+    return remove_key(key);
+  }
+
+  /**
+    @brief Rimuove tutti gli elementi che soddisfano un predicato
+
+    Gli elementi vengono scollegati durante una sola passata sulla lista.
+
+    @param pred predicato booleano sui dati T
+
+    @post _size = _size - numero di elementi rimossi
+
+    @return numero di elementi rimossi
+  */
+  template <typename P>
+  unsigned int remove_if(P pred)
+  {
+    unsigned int removed = 0;
+    node **link = &_head;
+
+    while (*link != nullptr)
     {
-      node *tmp = _head;
-      _head = tmp->next;
-      delete tmp;
-      tmp = nullptr; ///< per sicurezza
-      --_size;
-      return true;
+      node *curr = *link;
+      if (pred(curr->val))
+      {
+        record(CHANGE_REMOVE, curr->val);
+        *link = curr->next;
+        destroy_node(curr);
+        --_size;
+        ++removed;
+        invalidate();
+      }
+      else
+        link = &(curr->next);
     }
+    return removed;
+  }
 
-    node *prev = find_internal(val);
-    // find non ha trovato elemento con valore val
-    if (prev == nullptr)
-      return false;
+  /**
+    @brief Rimuove dal Set tutti gli elementi di una sequenza
 
-    node *culprit = prev->next;
+    La sequenza viene inserita in una tabella hash e gli elementi da rimuovere vengono
+    scollegati durante una sola passata sulla lista: O(n + k) invece di O(n * k).
 
-    prev->next = culprit->next;
-    delete culprit;
-    culprit = nullptr; ///< per sicurezza
-    --_size;
-    return true;
+    Il funtore Hash deve essere coerente con Equals: se Equals(a, b) allora Hash(a) == Hash(b).
+
+    @param first iteratore all'inizio della sequenza
+    @param last iteratore alla fine della sequenza
+    @param hash funtore di hash sui dati T
+
+    @post _size = _size - numero di elementi rimossi
+
+    @return numero di elementi rimossi
+
+    @throw std::bad_alloc possibile eccezione di allocazione (il Set non viene modificato)
+  */
+  template <typename Iter, typename Hash = std::hash<typename std::remove_cv<T>::type> >
+  unsigned int remove(Iter first, Iter last, Hash hash = Hash())
+  {
+    batch_table<T, Equals, Hash> batch(first, last, hash);
+    const std::size_t k = batch.vals.size();
+
+    if (k == 0 || _size == 0)
+      return 0;
+    for (std::size_t i = 0; i < k; ++i)
+      batch.insert(i);
+
+    unsigned int removed = 0;
+    node **link = &_head;
+
+    while (*link != nullptr)
+    {
+      node *curr = *link;
+      if (batch.find(curr->val, hash(curr->val)) != k)
+      {
+        record(CHANGE_REMOVE, curr->val);
+        *link = curr->next;
+        destroy_node(curr);
+        --_size;
+        ++removed;
+        invalidate();
+      }
+      else
+        link = &(curr->next);
+    }
+    return removed;
   }
 
   /**
@@ -385,12 +1129,112 @@ public:
   */
   bool find(const T &val) const
   {
-    if (_size == 0)
-      return false;
-    // per come e' implementata find_internal(), mi devo assicurare che il valore da trovare non sia in _head
-    if (_equals(_head->val, val))
-      return true;
-    return find_internal(val) != nullptr;
+    return find_key(val);
+  }
+
+  /**
+    @brief ricerca di una chiave di tipo qualsiasi nel Set
+
+    Disponibile solo se Equals e' trasparente (definisce is_transparent) e sa confrontare
+    un T con un K: la chiave non viene convertita in T.
+
+    @param key chiave da cercare nel Set
+
+    @return true se un elemento uguale a key e' presente nel Set, false altrimenti
+  */
+  template <typename K, typename E = Equals, typename = typename E::is_transparent>
+  bool find(const K &key) const
+  {
+    return find_key(key);
+  }
+
+  /**
+    @brief Sinonimo di find
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool contains(const T &val) const
+  {
+    return find_key(val);
+  }
+
+  /**
+    @brief ricerca di un valore con riorganizzazione della lista secondo la politica corrente
+
+    Con REORDER_NONE equivale a find.
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool find_and_promote(const T &val)
+  {
+    if (_policy == REORDER_NONE)
+      return find_key(val);
+    return find_reorder(val) != nullptr;
+  }
+
+  /**
+    @brief Sinonimo di find per chiavi di tipo qualsiasi (Equals trasparente)
+
+    @param key chiave da cercare nel Set
+
+    @return true se un elemento uguale a key e' presente nel Set, false altrimenti
+  */
+  template <typename K, typename E = Equals, typename = typename E::is_transparent>
+  bool contains(const K &key) const
+  {
+    return find_key(key);
+  }
+
+  /**
+    @brief ricerca di una sequenza di valori nel Set
+
+    Le chiavi cercate vengono inserite in una tabella hash e tutte le ricerche avvengono durante
+    una sola passata sulla lista, interrotta appena tutte le chiavi sono state trovate.
+    Per ogni chiave della sequenza viene scritto in out un bool (true se presente nel Set).
+
+    Il funtore Hash deve essere coerente con Equals: se Equals(a, b) allora Hash(a) == Hash(b).
+
+    @param first iteratore all'inizio della sequenza di chiavi
+    @param last iteratore alla fine della sequenza di chiavi
+    @param out iteratore di output su cui scrivere i risultati, nell'ordine della sequenza
+    @param hash funtore di hash sui dati T
+
+    @return numero di chiavi della sequenza presenti nel Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Iter, typename OutIter, typename Hash = std::hash<typename std::remove_cv<T>::type> >
+  unsigned int find_many(Iter first, Iter last, OutIter out, Hash hash = Hash()) const
+  {
+    batch_table<T, Equals, Hash> batch(first, last, hash);
+    const std::size_t k = batch.vals.size();
+    std::vector<std::size_t> rep;
+    std::vector<char> found(k, 0);
+    std::size_t missing = batch.insert_all(rep);
+
+    for (const node *curr = _head; curr != nullptr && missing != 0; curr = curr->next)
+    {
+      std::size_t j = batch.find(curr->val, hash(curr->val));
+      if (j != k)
+      {
+        found[j] = 1;
+        --missing;
+      }
+    }
+
+    unsigned int hits = 0;
+    for (std::size_t i = 0; i < k; ++i)
+    {
+      bool f = found[rep[i]];
+      hits += f;
+      *out = f;
+      ++out;
+    }
+    return hits;
   }
 
   /**
@@ -419,7 +1263,12 @@ public:
   /**
   @brief classe const_iterator
 
-  Classe interna di iteratori costanti (sola lettura) per iterare sul Set
+  Classe interna di iteratori costanti (sola lettura) per iterare sul Set.
+  Oltre al nodo corrente l'iteratore porta il collegamento al nodo precedente (il next del
+  precedente o _head), che permette ad erase di scollegare il nodo in O(1), e il Set su cui itera,
+  che erase controlla sempre: anche con SET_ITERATOR_CHECKS a 0 occupa tre puntatori e ogni
+  incremento aggiorna anche il collegamento.
+  I controlli aggiuntivi dipendono da SET_ITERATOR_CHECKS (vedi storage.h).
 
   */
   class const_iterator
@@ -436,7 +1285,12 @@ public:
 
       @post _ptr = nullptr
     */
-    const_iterator() : _ptr(nullptr) {}
+    const_iterator() : _ptr(nullptr), _link(nullptr), _set(nullptr)
+#if SET_ITERATOR_CHECKS >= 2
+        , _gen(0)
+#endif
+    {
+    }
 
     /**
       @brief Copy constructor
@@ -445,7 +1299,12 @@ public:
 
       @post _ptr = other._ptr
     */
-    const_iterator(const const_iterator &other) : _ptr(other._ptr) {}
+    const_iterator(const const_iterator &other) : _ptr(other._ptr), _link(other._link), _set(other._set)
+#if SET_ITERATOR_CHECKS >= 2
+        , _gen(other._gen)
+#endif
+    {
+    }
 
     /**
       @brief Operatore di assegnamento
@@ -459,6 +1318,11 @@ public:
     const_iterator &operator=(const const_iterator &other)
     {
       _ptr = other._ptr;
+      _link = other._link;
+      _set = other._set;
+#if SET_ITERATOR_CHECKS >= 2
+      _gen = other._gen;
+#endif
       return *this;
     }
 
@@ -474,12 +1338,11 @@ public:
 
       @return reference al valore dell'elemento puntato da _ptr
 
-      @throw myexcp::myexcp_domain_error se viene dereferenziato un nullptr
+      @throw myexcp::myexcp_domain_error se viene dereferenziato un nullptr o un iteratore invalidato
     */
     reference operator*() const
     {
-      if (_ptr == nullptr)
-        throw(myexcp_domain_error("Dereferencing nullptr"));
+      check();
       return _ptr->val;
     }
 
@@ -490,8 +1353,7 @@ public:
     */
     pointer operator->() const
     {
-      if (_ptr == nullptr)
-        throw(myexcp_domain_error("Dereferencing nullptr"));
+      check();
       return &(_ptr->val);
     }
 
@@ -508,9 +1370,9 @@ public:
     */
     const_iterator operator++(int)
     {
-      if (_ptr == nullptr)
-        throw(myexcp_domain_error("Dereferencing nullptr"));
+      check();
       const_iterator tmp(*this);
+      _link = &(_ptr->next);
       _ptr = _ptr->next;
       return tmp;
     }
@@ -526,8 +1388,8 @@ public:
     */
     const_iterator &operator++()
     {
-      if (_ptr == nullptr)
-        throw(myexcp_domain_error("Dereferencing nullptr"));
+      check();
+      _link = &(_ptr->next);
       _ptr = _ptr->next;
       return *this;
     }
@@ -560,10 +1422,37 @@ public:
 
   private:
     const node *_ptr;
+    node *const *_link; ///< puntatore al next del nodo precedente (o a _head), usato da erase
+    const Set *_set;    ///< Set su cui si itera, controllato da erase
+#if SET_ITERATOR_CHECKS >= 2
+    unsigned long _gen; ///< _set->_generation alla creazione dell'iteratore
+#endif
 
     friend class Set;
 
-    const_iterator(const node *p) : _ptr(p) {}
+    const_iterator(const node *p, node *const *link, const Set *s) : _ptr(p), _link(link), _set(s)
+#if SET_ITERATOR_CHECKS >= 2
+        , _gen(s->_generation)
+#endif
+    {
+    }
+
+    /**
+      @brief Controlli sull'iteratore secondo SET_ITERATOR_CHECKS
+
+      @throw myexcp::myexcp_domain_error se l'iteratore e' end() o e' stato invalidato
+    */
+    void check() const
+    {
+#if SET_ITERATOR_CHECKS >= 1
+      if (_ptr == nullptr)
+        SET_THROW(myexcp_domain_error("Dereferencing nullptr"));
+#endif
+#if SET_ITERATOR_CHECKS >= 2
+      if (_set != nullptr && _set->_generation != _gen)
+        SET_THROW(myexcp_domain_error("Invalidated iterator"));
+#endif
+    }
   };
 
   /**
@@ -573,7 +1462,7 @@ public:
   */
   const_iterator begin() const
   {
-    return const_iterator(_head);
+    return const_iterator(_head, &_head, this);
   }
 
   /**
@@ -583,13 +1472,103 @@ public:
   */
   const_iterator end() const
   {
-    return const_iterator(nullptr);
+    return const_iterator(nullptr, nullptr, this);
+  }
+
+  /**
+    @brief ricerca di un valore nel Set
+
+    A differenza di find restituisce la posizione dell'elemento, che puo' essere passata ad erase
+    senza una seconda scansione. Non riorganizza la lista.
+
+    @param val valore da cercare nel Set
+
+    @return iteratore all'elemento uguale a val, end() se non esiste
+  */
+  const_iterator find_iter(const T &val) const
+  {
+    node *const *link = &_head;
+    while (*link != nullptr && !_equals((*link)->val, val))
+      link = &((*link)->next);
+    return const_iterator(*link, link, this);
+  }
+
+  /**
+    @brief Rimuove l'elemento in posizione pos
+
+    L'iteratore contiene il collegamento al nodo precedente, quindi il nodo viene scollegato in O(1).
+    Se la lista e' cambiata davanti a pos (add in testa, riorganizzazione) il precedente viene
+    cercato di nuovo.
+
+    @param pos iteratore all'elemento da rimuovere (diverso da end())
+
+    @return iteratore all'elemento successivo a quello rimosso
+
+    @post _size = _size - 1
+
+    @throw myexcp::myexcp_domain_error se pos e' end(), e' stato invalidato o non appartiene al Set
+  */
+  const_iterator erase(const_iterator pos)
+  {
+    // il controllo del Set di appartenenza non dipende da SET_ITERATOR_CHECKS: scollegare il nodo
+    // da un altro Set corromperebbe entrambi
+    pos.check();
+    if (pos._set != this)
+      SET_THROW(myexcp_domain_error("Iterator not in Set"));
+
+    node **link = const_cast<node **>(pos._link);
+    if (link == nullptr || *link != pos._ptr)
+    {
+      link = &_head;
+      while (*link != nullptr && *link != pos._ptr)
+        link = &((*link)->next);
+      if (*link == nullptr)
+        SET_THROW(myexcp_domain_error("Iterator not in Set"));
+    }
+
+    node *culprit = *link;
+    record(CHANGE_REMOVE, culprit->val);
+    *link = culprit->next;
+    destroy_node(culprit);
+    culprit = nullptr; ///< per sicurezza
+    --_size;
+    invalidate();
+    return const_iterator(*link, link, this);
+  }
+};
+
+/**
+  @brief Funtore di uguaglianza trasparente basato su una proiezione
+
+  Due elementi T vengono confrontati con Equals; un elemento T e una chiave K di altro tipo
+  vengono confrontati con Proj(T) == K. Permette di cercare gli elementi di un Set per una parte
+  dei loro campi (es. una person per nome e cognome) senza costruire un T completo.
+*/
+template <typename T, typename Equals, typename Proj>
+struct projected_equal
+{
+  typedef void is_transparent;
+
+  Equals equals; ///< uguaglianza tra elementi
+  Proj proj;     ///< proiezione di un elemento sulla chiave
+
+  bool operator()(const T &a, const T &b) const
+  {
+    return equals(a, b);
+  }
+
+  template <typename K>
+  bool operator()(const T &a, const K &key) const
+  {
+    return proj(a) == key;
   }
 };
 
 /**
     @brief Crea un nuovo Set con tutti e soli gli elementi del Set di partenza che soddisfano un certo predicato
 
+    Versione generica per qualsiasi storage (iteratori e add).
+
     @param mset Set di partenza
     @param pred predicato booleano filtro
 
@@ -597,14 +1576,14 @@ public:
 
     @throw std::bad_alloc possibile eccezione di allocazione
   */
-template <typename T, typename E, typename P>
-Set<T, E> filter_out(const Set<T, E> &mset, P pred)
+template <typename T, typename E, typename S, typename P>
+Set<T, E, S> filter_out(const Set<T, E, S> &mset, P pred)
 {
-  Set<T, E> out_set;
-  typename Set<T, E>::const_iterator beg = mset.begin(),
+  Set<T, E, S> out_set;
+  typename Set<T, E, S>::const_iterator beg = mset.begin(),
                                      end = mset.end();
 
-  try
+  SET_TRY
   {
     while (beg != end)
     {
@@ -613,10 +1592,9 @@ Set<T, E> filter_out(const Set<T, E> &mset, P pred)
       ++beg;
     }
   }
-  catch (...)
+  SET_CATCH_ALL
   {
-    std::cerr << ("   %%%   ERROR IN MEMORY ALLOCATION   %%%");
-    throw;
+    SET_ALLOC_ERROR();
   }
   return out_set;
 }
@@ -624,6 +1602,8 @@ Set<T, E> filter_out(const Set<T, E> &mset, P pred)
 /**
     @brief Concatenazione di due set
 
+    Versione generica per qualsiasi storage (iteratori e add).
+
     @param set1 primo Set da concatenare
     @param set2 secondo Set da concatenare
 
@@ -631,13 +1611,13 @@ Set<T, E> filter_out(const Set<T, E> &mset, P pred)
 
     @throw std::bad_alloc possibile eccezione di allocazione
   */
-template <typename T, typename E>
-Set<T, E> operator+(const Set<T, E> &set1, const Set<T, E> &set2)
+template <typename T, typename E, typename S>
+Set<T, E, S> operator+(const Set<T, E, S> &set1, const Set<T, E, S> &set2)
 {
-  Set<T, E> out_set = set2;
-  typename Set<T, E>::const_iterator beg = set1.begin(),
+  Set<T, E, S> out_set = set2;
+  typename Set<T, E, S>::const_iterator beg = set1.begin(),
                                      end = set1.end();
-  try
+  SET_TRY
   {
     while (beg != end)
     {
@@ -645,10 +1625,9 @@ Set<T, E> operator+(const Set<T, E> &set1, const Set<T, E> &set2)
       ++beg;
     }
   }
-  catch (...)
+  SET_CATCH_ALL
   {
-    std::cerr << ("   %%%   ERROR IN MEMORY ALLOCATION   %%%");
-    throw;
+    SET_ALLOC_ERROR();
   }
   return out_set;
 }
@@ -656,6 +1635,8 @@ Set<T, E> operator+(const Set<T, E> &set1, const Set<T, E> &set2)
 /**
     @brief Intersezione di due Set
 
+    Versione generica per qualsiasi storage (iteratori e find).
+
     @param set1 primo Set da intersecare
     @param set2 secondo Set da intersecare
 
@@ -663,14 +1644,14 @@ Set<T, E> operator+(const Set<T, E> &set1, const Set<T, E> &set2)
 
     @throw std::bad_alloc possibile eccezione di allocazione
   */
-template <typename T, typename E>
-Set<T, E> operator-(const Set<T, E> &set1, const Set<T, E> &set2)
+template <typename T, typename E, typename S>
+Set<T, E, S> operator-(const Set<T, E, S> &set1, const Set<T, E, S> &set2)
 {
-  Set<T, E> out_set;
-  typename Set<T, E>::const_iterator beg = set1.begin(),
+  Set<T, E, S> out_set;
+  typename Set<T, E, S>::const_iterator beg = set1.begin(),
                                      end = set1.end();
 
-  try
+  SET_TRY
   {
     while (beg != end)
     {
@@ -679,10 +1660,9 @@ Set<T, E> operator-(const Set<T, E> &set1, const Set<T, E> &set2)
       ++beg;
     }
   }
-  catch (...)
+  SET_CATCH_ALL
   {
-    std::cerr << ("   %%%   ERROR IN MEMORY ALLOCATION   %%%");
-    throw;
+    SET_ALLOC_ERROR();
   }
 
   return out_set;
@@ -0,0 +1,461 @@
+#ifndef SETINDEX_H
+#define SETINDEX_H
+
+#include "set.h"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+/**
+  @brief Iteratore sugli elementi di un indice secondario
+
+  Adatta un iteratore di una (multi)mappa chiave -> elemento restituendo solo l'elemento.
+*/
+template <typename MapIter, typename V>
+class index_iterator
+{
+  MapIter _it; ///< posizione nella mappa dell'indice
+
+public:
+  typedef std::forward_iterator_tag iterator_category;
+  typedef V value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef const V *pointer;
+  typedef const V &reference;
+
+  index_iterator() {}
+  explicit index_iterator(MapIter it) : _it(it) {}
+
+  reference operator*() const
+  {
+    return _it->second;
+  }
+
+  pointer operator->() const
+  {
+    return &(_it->second);
+  }
+
+  index_iterator &operator++()
+  {
+    ++_it;
+    return *this;
+  }
+
+  index_iterator operator++(int)
+  {
+    index_iterator tmp(*this);
+    ++_it;
+    return tmp;
+  }
+
+  bool operator==(const index_iterator &other) const
+  {
+    return _it == other._it;
+  }
+
+  bool operator!=(const index_iterator &other) const
+  {
+    return _it != other._it;
+  }
+};
+
+/**
+  @brief Risultato di una ricerca su un indice secondario: coppia di iteratori sugli elementi
+
+  Valido finche' il Set indicizzato non viene modificato.
+*/
+template <typename Iter>
+struct index_range
+{
+  Iter first; ///< primo elemento
+  Iter last;  ///< fine dell'intervallo
+
+  Iter begin() const
+  {
+    return first;
+  }
+
+  Iter end() const
+  {
+    return last;
+  }
+
+  bool empty() const
+  {
+    return first == last;
+  }
+
+  /**
+    @brief Numero di elementi dell'intervallo (lineare nel risultato)
+
+    @return numero di elementi
+  */
+  std::size_t size() const
+  {
+    return std::distance(first, last);
+  }
+};
+
+/**
+  @brief Base degli indici secondari su un Set a lista
+
+  Osserva il change log del Set indicizzato (attivato se necessario) e inoltra ogni add/remove
+  effettiva all'indice. Se il change log viene sostituito o disattivato l'indice viene ricostruito
+  con una passata sul Set alla prima ricerca; se il Set viene distrutto l'indice si svuota.
+*/
+template <typename T, typename Equals>
+class set_index_base : private change_listener<typename std::remove_cv<T>::type>
+{
+public:
+  typedef typename std::remove_cv<T>::type value_type;
+  typedef Set<T, Equals, ListStorage> source_set; ///< Set indicizzato
+
+  static const std::size_t DEFAULT_LOG_CAPACITY = 1024; ///< capacita' del change log attivato dall'indice
+
+private:
+  source_set *_source;           ///< Set indicizzato, nullptr se e' stato distrutto
+  change_log<value_type> *_log; ///< change log osservato, nullptr se non e' attivo
+  bool _stale;                   ///< true se l'indice va ricostruito
+
+  void on_change(const set_change<value_type> &change)
+  {
+    if (_stale)
+      return;
+    SET_TRY
+    {
+      if (change.kind == CHANGE_ADD)
+        insert_entry(change.val);
+      else
+        erase_entry(change.val);
+    }
+    SET_CATCH_ALL
+    {
+      _stale = true;
+    }
+  }
+
+  void on_detach(bool destroyed)
+  {
+    _log = nullptr;
+    _stale = true;
+    if (destroyed)
+      _source = nullptr;
+  }
+
+protected:
+  Equals _equals; ///< funtore di uguaglianza degli elementi
+
+  /**
+    @brief Aggiunge un elemento all'indice
+
+    @param val elemento aggiunto al Set
+  */
+  virtual void insert_entry(const value_type &val) = 0;
+
+  /**
+    @brief Rimuove un elemento dall'indice
+
+    @param val elemento rimosso dal Set
+  */
+  virtual void erase_entry(const value_type &val) = 0;
+
+  /**
+    @brief Svuota l'indice
+  */
+  virtual void clear_entries() = 0;
+
+  /**
+    @brief Ricostruisce l'indice se non e' allineato al Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void sync()
+  {
+    if (!_stale)
+      return;
+    clear_entries();
+    if (_source == nullptr)
+      return;
+    for (typename source_set::const_iterator it = _source->begin(); it != _source->end(); ++it)
+      insert_entry(*it);
+
+    if (_log != _source->changes())
+    {
+      _log = _source->changes();
+      if (_log != nullptr)
+        _log->subscribe(this);
+    }
+    _stale = (_log == nullptr);
+  }
+
+  /**
+    @brief Costruttore: collega l'indice al change log del Set
+
+    Le classi derivate chiamano sync() alla fine del proprio costruttore.
+
+    @param source Set da indicizzare
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  explicit set_index_base(source_set &source) : _source(&source), _log(nullptr), _stale(true)
+  {
+    if (source.changes() == nullptr)
+      source.set_change_log(DEFAULT_LOG_CAPACITY);
+  }
+
+  ~set_index_base()
+  {
+    if (_log != nullptr)
+      _log->unsubscribe(this);
+  }
+
+public:
+  set_index_base(const set_index_base &) = delete;
+  set_index_base &operator=(const set_index_base &) = delete;
+};
+
+/**
+  @brief classe sorted_index
+
+  Indice ordinato su una proiezione degli elementi (es. person::age): ricerche per uguaglianza e per
+  intervallo in O(log n + k) invece della passata completa di filter_out.
+
+  @tparam T tipo degli elementi
+  @tparam Equals funtore di uguaglianza
+  @tparam Proj proiezione T -> chiave
+  @tparam Less ordinamento stretto delle chiavi
+*/
+template <typename T, typename Equals, typename Proj, typename Less = std::less<void> >
+class sorted_index : public set_index_base<T, Equals>
+{
+public:
+  typedef set_index_base<T, Equals> base;
+  typedef typename base::value_type value_type;
+  typedef typename std::decay<decltype(std::declval<Proj &>()(std::declval<const value_type &>()))>::type key_type;
+  typedef std::multimap<key_type, value_type, Less> map_type;
+  typedef index_iterator<typename map_type::const_iterator, value_type> const_iterator;
+  typedef index_range<const_iterator> range_type;
+
+private:
+  map_type _map; ///< chiave -> elemento
+  Proj _proj;    ///< proiezione
+
+  void insert_entry(const value_type &val)
+  {
+    _map.insert(std::make_pair(_proj(val), val));
+  }
+
+  void erase_entry(const value_type &val)
+  {
+    std::pair<typename map_type::iterator, typename map_type::iterator> r = _map.equal_range(_proj(val));
+    for (; r.first != r.second; ++r.first)
+      if (this->_equals(r.first->second, val))
+      {
+        _map.erase(r.first);
+        return;
+      }
+  }
+
+  void clear_entries()
+  {
+    _map.clear();
+  }
+
+  range_type make_range(typename map_type::const_iterator first, typename map_type::const_iterator last) const
+  {
+    range_type r = {const_iterator(first), const_iterator(last)};
+    return r;
+  }
+
+public:
+  /**
+    @brief Costruttore: indicizza gli elementi correnti del Set
+
+    @param source Set da indicizzare (se non ha un change log ne viene attivato uno)
+    @param proj proiezione sulla chiave
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  explicit sorted_index(typename base::source_set &source, Proj proj = Proj()) : base(source), _proj(proj)
+  {
+    this->sync();
+  }
+
+  /**
+    @brief Elementi con chiave uguale a key
+
+    @param key chiave cercata
+
+    @return intervallo degli elementi con proiezione equivalente a key
+  */
+  range_type equal(const key_type &key)
+  {
+    this->sync();
+    std::pair<typename map_type::const_iterator, typename map_type::const_iterator> r = _map.equal_range(key);
+    return make_range(r.first, r.second);
+  }
+
+  /**
+    @brief Elementi con chiave in [lo, hi)
+
+    @param lo estremo inferiore (incluso)
+    @param hi estremo superiore (escluso)
+
+    @return intervallo degli elementi, in ordine di chiave
+  */
+  range_type range(const key_type &lo, const key_type &hi)
+  {
+    this->sync();
+    typename map_type::const_iterator first = _map.lower_bound(lo);
+    typename map_type::const_iterator last = _map.lower_bound(hi);
+    if (_map.key_comp()(hi, lo))
+      last = first;
+    return make_range(first, last);
+  }
+
+  /**
+    @brief Elementi con chiave maggiore di key
+
+    @param key estremo inferiore (escluso)
+
+    @return intervallo degli elementi, in ordine di chiave
+  */
+  range_type above(const key_type &key)
+  {
+    this->sync();
+    return make_range(_map.upper_bound(key), _map.end());
+  }
+
+  /**
+    @brief Elementi con chiave minore di key
+
+    @param key estremo superiore (escluso)
+
+    @return intervallo degli elementi, in ordine di chiave
+  */
+  range_type below(const key_type &key)
+  {
+    this->sync();
+    return make_range(_map.begin(), _map.lower_bound(key));
+  }
+
+  /**
+    @brief Numero di elementi indicizzati
+
+    @return numero di elementi del Set
+  */
+  std::size_t size()
+  {
+    this->sync();
+    return _map.size();
+  }
+};
+
+/**
+  @brief classe hash_index
+
+  Indice hash su una proiezione degli elementi (es. person::surname): ricerche per uguaglianza
+  in O(1) medio invece della passata completa di filter_out.
+
+  @tparam T tipo degli elementi
+  @tparam Equals funtore di uguaglianza
+  @tparam Proj proiezione T -> chiave
+  @tparam Hash funtore di hash delle chiavi
+*/
+template <typename T, typename Equals, typename Proj, typename Hash = set_hash>
+class hash_index : public set_index_base<T, Equals>
+{
+public:
+  typedef set_index_base<T, Equals> base;
+  typedef typename base::value_type value_type;
+  typedef typename std::decay<decltype(std::declval<Proj &>()(std::declval<const value_type &>()))>::type key_type;
+  typedef std::unordered_multimap<key_type, value_type, Hash> map_type;
+  typedef index_iterator<typename map_type::const_iterator, value_type> const_iterator;
+  typedef index_range<const_iterator> range_type;
+
+private:
+  map_type _map; ///< chiave -> elemento
+  Proj _proj;    ///< proiezione
+
+  void insert_entry(const value_type &val)
+  {
+    _map.insert(std::make_pair(_proj(val), val));
+  }
+
+  void erase_entry(const value_type &val)
+  {
+    std::pair<typename map_type::iterator, typename map_type::iterator> r = _map.equal_range(_proj(val));
+    for (; r.first != r.second; ++r.first)
+      if (this->_equals(r.first->second, val))
+      {
+        _map.erase(r.first);
+        return;
+      }
+  }
+
+  void clear_entries()
+  {
+    _map.clear();
+  }
+
+public:
+  /**
+    @brief Costruttore: indicizza gli elementi correnti del Set
+
+    @param source Set da indicizzare (se non ha un change log ne viene attivato uno)
+    @param proj proiezione sulla chiave
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  explicit hash_index(typename base::source_set &source, Proj proj = Proj()) : base(source), _proj(proj)
+  {
+    this->sync();
+  }
+
+  /**
+    @brief Elementi con chiave uguale a key
+
+    @param key chiave cercata
+
+    @return intervallo degli elementi con proiezione uguale a key (in ordine qualsiasi)
+  */
+  range_type equal(const key_type &key)
+  {
+    this->sync();
+    std::pair<typename map_type::const_iterator, typename map_type::const_iterator> r = _map.equal_range(key);
+    range_type result = {const_iterator(r.first), const_iterator(r.second)};
+    return result;
+  }
+
+  /**
+    @brief Numero di elementi con chiave uguale a key
+
+    @param key chiave cercata
+
+    @return numero di elementi
+  */
+  std::size_t count(const key_type &key)
+  {
+    this->sync();
+    return _map.count(key);
+  }
+
+  /**
+    @brief Numero di elementi indicizzati
+
+    @return numero di elementi del Set
+  */
+  std::size_t size()
+  {
+    this->sync();
+    return _map.size();
+  }
+};
+
+#endif
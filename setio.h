@@ -0,0 +1,343 @@
+#ifndef SETIO_H
+#define SETIO_H
+
+#include "set.h"
+
+#include <charconv>
+#include <cctype>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+/**
+  @brief Indica se un tipo viene scritto e letto con std::to_chars / std::from_chars
+
+  Tutti i tipi aritmetici tranne bool e i tipi carattere (che operator<< stampa come caratteri).
+*/
+template <typename V>
+struct set_io_numeric
+    : std::integral_constant<bool, std::is_arithmetic<V>::value &&
+                                       !std::is_same<V, bool>::value &&
+                                       !std::is_same<V, char>::value &&
+                                       !std::is_same<V, signed char>::value &&
+                                       !std::is_same<V, unsigned char>::value &&
+                                       !std::is_same<V, wchar_t>::value &&
+                                       !std::is_same<V, char16_t>::value &&
+                                       !std::is_same<V, char32_t>::value>
+{
+};
+
+/**
+  @brief Scrittura bufferizzata di testo su un ostream
+
+  I caratteri vengono accumulati in un buffer e scritti sull'ostream a blocchi di BUFFER_SIZE byte;
+  i tipi numerici sono convertiti con std::to_chars direttamente nel buffer, stringhe e caratteri
+  copiati, gli altri formattati con operator<< su uno stream interno (con il formato di os) e poi
+  copiati: l'ostream riceve solo blocchi pieni.
+*/
+class set_text_writer
+{
+  static const std::size_t BUFFER_SIZE = 1 << 16; ///< dimensione del buffer
+  static const std::size_t MAX_NUMBER = 128;      ///< spazio massimo occupato da un numero
+
+  std::ostream &_os;      ///< ostream di destinazione
+  std::vector<char> _buf; ///< caratteri non ancora scritti
+  std::size_t _len;       ///< numero di caratteri nel buffer
+  std::ostringstream _fmt; ///< stream per i tipi stampabili solo con operator<<
+
+public:
+  /**
+    @brief Costruttore
+
+    @param os ostream su cui scrivere
+  */
+  explicit set_text_writer(std::ostream &os) : _os(os), _buf(BUFFER_SIZE), _len(0)
+  {
+    _fmt.copyfmt(_os);
+  }
+
+  /**
+    @brief Distruttore, scrive i caratteri rimasti nel buffer
+  */
+  ~set_text_writer()
+  {
+    flush();
+  }
+
+  /**
+    @brief Scrive sull'ostream il contenuto del buffer
+  */
+  void flush()
+  {
+    if (_len != 0)
+      _os.write(_buf.data(), _len);
+    _len = 0;
+  }
+
+  /**
+    @brief Aggiunge una sequenza di caratteri
+
+    @param s caratteri da scrivere
+  */
+  void put(std::string_view s)
+  {
+    if (_len + s.size() > _buf.size())
+    {
+      flush();
+      if (s.size() > _buf.size())
+      {
+        _os.write(s.data(), s.size());
+        return;
+      }
+    }
+    s.copy(_buf.data() + _len, s.size());
+    _len += s.size();
+  }
+
+  /**
+    @brief Aggiunge un valore nello stesso formato di operator<<
+
+    I numeri in virgola mobile sono scritti nella forma piu' corta che rilegge lo stesso valore
+    (puo' differire dalla precisione di default degli ostream).
+
+    @param v valore da scrivere
+  */
+  template <typename V>
+  void value(const V &v)
+  {
+    if constexpr (set_io_numeric<V>::value)
+    {
+      if (_len + MAX_NUMBER > _buf.size())
+        flush();
+      std::to_chars_result res = std::to_chars(_buf.data() + _len, _buf.data() + _buf.size(), v);
+      _len = res.ptr - _buf.data();
+    }
+    else if constexpr (std::is_same<V, bool>::value)
+      put(v ? "1" : "0");
+    else if constexpr (std::is_same<V, char>::value)
+      put(std::string_view(&v, 1));
+    else if constexpr (std::is_convertible<const V &, std::string_view>::value)
+      put(std::string_view(v));
+    else
+    {
+      _fmt.str(std::string());
+      _fmt << v;
+      put(_fmt.str());
+    }
+  }
+};
+
+/**
+  @brief Scrive un Set nel formato di operator<< ({a, b, c}) usando un buffer e std::to_chars
+
+  @param os ostream su cui scrivere
+  @param mset Set da scrivere
+*/
+template <typename T, typename E, typename S>
+void write_set(std::ostream &os, const Set<T, E, S> &mset)
+{
+  set_text_writer out(os);
+  bool first = true;
+
+  out.put("{");
+  for (typename Set<T, E, S>::const_iterator it = mset.begin(); it != mset.end(); ++it)
+  {
+    if (!first)
+      out.put(", ");
+    first = false;
+    out.value(*it);
+  }
+  out.put("}");
+}
+
+/**
+  @brief Converte un elemento letto da testo
+
+  @param tok testo dell'elemento (senza spazi iniziali e finali)
+  @param v valore letto
+
+  @return true se tok e' un valore valido di tipo V (tok vuoto solo per i tipi costruibili da testo)
+*/
+template <typename V>
+bool set_io_parse(std::string_view tok, V &v)
+{
+  if constexpr (set_io_numeric<V>::value)
+  {
+    std::from_chars_result res = std::from_chars(tok.data(), tok.data() + tok.size(), v);
+    return res.ec == std::errc() && res.ptr == tok.data() + tok.size();
+  }
+  else if constexpr (std::is_same<V, bool>::value)
+  {
+    if (tok != "0" && tok != "1")
+      return false;
+    v = (tok == "1");
+    return true;
+  }
+  else if constexpr (std::is_same<V, char>::value)
+  {
+    if (tok.size() != 1)
+      return false;
+    v = tok[0];
+    return true;
+  }
+  else if constexpr (std::is_constructible<V, std::string_view>::value)
+  {
+    v = V(tok);
+    return true;
+  }
+  else
+  {
+    std::istringstream in{std::string(tok)};
+    in >> v;
+    return !in.fail() && in.peek() == std::char_traits<char>::eof();
+  }
+}
+
+/**
+  @brief Aggiunge al Set un blocco di elementi letti
+
+  Versione generica: add su ogni elemento.
+
+  @param mset Set di destinazione
+  @param batch elementi letti
+  @param unique true se gli elementi sono sicuramente nuovi e distinti (ignorato)
+*/
+template <typename T, typename E, typename S, typename V>
+void set_io_append(Set<T, E, S> &mset, const std::vector<V> &batch, bool unique)
+{
+  (void)unique;
+  for (std::size_t i = 0; i < batch.size(); ++i)
+    mset.add(batch[i]);
+}
+
+/**
+  @brief Aggiunge al Set a lista un blocco di elementi letti
+
+  Con unique gli elementi vengono collegati senza cercare duplicati (insert_unique).
+
+  @param mset Set di destinazione
+  @param batch elementi letti
+  @param unique true se gli elementi sono sicuramente nuovi e distinti
+*/
+template <typename T, typename E, typename V>
+void set_io_append(Set<T, E, ListStorage> &mset, const std::vector<V> &batch, bool unique)
+{
+  if (unique)
+    mset.insert_unique(batch.begin(), batch.end());
+  else
+    for (std::size_t i = 0; i < batch.size(); ++i)
+      mset.add(batch[i]);
+}
+
+/**
+  @brief Legge un Set nel formato prodotto da operator<< e write_set ({a, b, c})
+
+  L'input viene letto carattere per carattere dal buffer dello stream (nessun carattere dopo '}'
+  viene consumato) e gli elementi vengono aggiunti al Set a blocchi di BATCH_SIZE, quindi la
+  memoria usata non dipende dalla dimensione dell'input. Gli spazi attorno agli elementi sono
+  ignorati; gli elementi non numerici non possono contenere ',' o '}'. Un elemento vuoto e' valido
+  solo per i tipi costruibili da testo (es. std::string).
+
+  @param is istream da cui leggere
+  @param mset Set a cui aggiungere gli elementi letti
+  @param unique true se l'input non contiene duplicati ne' elementi gia' presenti nel Set:
+                il Set a lista salta allora i controlli di unicita'
+
+  @return true se e' stato letto un Set valido; altrimenti viene impostato failbit su is
+          e mset contiene gli elementi letti prima dell'errore
+*/
+template <typename T, typename E, typename S>
+bool read_set(std::istream &is, Set<T, E, S> &mset, bool unique = false)
+{
+  typedef typename std::remove_cv<T>::type value_type;
+  typedef std::char_traits<char> traits;
+  const std::size_t BATCH_SIZE = 4096;
+
+  std::istream::sentry guard(is);
+  if (!guard)
+    return false;
+
+  std::streambuf *sb = is.rdbuf();
+  std::vector<value_type> batch;
+  std::string tok;
+  batch.reserve(BATCH_SIZE);
+
+  int c = sb->sgetc();
+  if (c != '{')
+  {
+    is.setstate(c == traits::eof() ? std::ios::eofbit | std::ios::failbit : std::ios::failbit);
+    return false;
+  }
+  sb->sbumpc();
+
+  c = sb->sgetc();
+  while (c != traits::eof() && std::isspace(c))
+    c = sb->snextc();
+  if (c == '}')
+  {
+    sb->sbumpc();
+    return true;
+  }
+
+  while (true)
+  {
+    // testo dell'elemento fino a ',' o '}'
+    tok.clear();
+    while (c != traits::eof() && c != ',' && c != '}')
+    {
+      tok.push_back(traits::to_char_type(c));
+      c = sb->snextc();
+    }
+    while (!tok.empty() && std::isspace(static_cast<unsigned char>(tok.back())))
+      tok.pop_back();
+
+    value_type v;
+    // un elemento vuoto (es. la stringa "" scritta come {a, , b}) lo valuta set_io_parse
+    if (c == traits::eof() || !set_io_parse(std::string_view(tok), v))
+    {
+      set_io_append(mset, batch, unique);
+      is.setstate(c == traits::eof() ? std::ios::eofbit | std::ios::failbit : std::ios::failbit);
+      return false;
+    }
+    batch.push_back(v);
+    if (batch.size() == BATCH_SIZE)
+    {
+      set_io_append(mset, batch, unique);
+      batch.clear();
+    }
+
+    sb->sbumpc();
+    if (c == '}')
+      break;
+    c = sb->sgetc();
+    while (c != traits::eof() && std::isspace(c))
+      c = sb->snextc();
+  }
+
+  set_io_append(mset, batch, unique);
+  return true;
+}
+
+/**
+  @brief Lettura di un Set dallo standard input
+
+  Overloading dell'operatore >> per leggere un Set nel formato di operator<<.
+  Il Set viene svuotato prima della lettura; in caso di errore viene impostato failbit.
+
+  @return istream da cui e' stato letto il Set
+*/
+template <typename T, typename E, typename S>
+std::istream &operator>>(std::istream &is, Set<T, E, S> &mset)
+{
+  mset.clear();
+  read_set(is, mset);
+  return is;
+}
+
+#endif
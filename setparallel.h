@@ -0,0 +1,413 @@
+#ifndef SETPARALLEL_H
+#define SETPARALLEL_H
+
+#include "set.h"
+#include "batch_table.h"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+  @brief Parametri delle operazioni parallele sui Set
+*/
+struct parallel_policy
+{
+  unsigned int threads;  ///< numero di partizioni e di thread (0 = std::thread::hardware_concurrency)
+  std::size_t threshold; ///< sotto questa somma delle dimensioni viene usata la versione seriale
+
+  /**
+    @brief Costruttore con i parametri di default
+  */
+  parallel_policy() : threads(0), threshold(1 << 16) {}
+};
+
+/**
+  @brief Partizioni hash di due Set, elaborate in parallelo
+
+  Gli elementi di entrambi i Set vengono distribuiti in P partizioni in base all'hash: elementi
+  uguali finiscono nella stessa partizione, quindi ogni coppia di partizioni puo' essere elaborata
+  da un thread diverso e i risultati parziali concatenati senza controlli di duplicati.
+  La partizione usa i bit alti dell'hash moltiplicato per la costante di Fibonacci, indipendenti
+  dai bit bassi di set_mix usati da batch_table.
+*/
+template <typename T, typename Equals, typename Hash>
+struct set_partitions
+{
+  typedef typename std::remove_cv<T>::type value_type;
+  typedef batch_table<T, Equals, Hash> table;
+
+  std::vector<std::vector<value_type> > left;  ///< partizioni del primo Set
+  std::vector<std::vector<value_type> > right; ///< partizioni del secondo Set
+  std::vector<std::vector<value_type> > out;   ///< risultati parziali
+  Hash hash;                                   ///< funtore di hash
+
+  /**
+    @brief Costruttore: distribuisce nelle partizioni gli elementi dei due Set
+
+    @param a primo Set
+    @param b secondo Set
+    @param parts numero di partizioni
+    @param h funtore di hash
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename SetA, typename SetB>
+  set_partitions(const SetA &a, const SetB &b, unsigned int parts, const Hash &h)
+      : left(parts), right(parts), out(parts), hash(h)
+  {
+    for (unsigned int p = 0; p < parts; ++p)
+    {
+      left[p].reserve(a.size() / parts + 1);
+      right[p].reserve(b.size() / parts + 1);
+    }
+    for (typename SetA::const_iterator it = a.begin(); it != a.end(); ++it)
+      left[part(*it)].push_back(*it);
+    for (typename SetB::const_iterator it = b.begin(); it != b.end(); ++it)
+      right[part(*it)].push_back(*it);
+  }
+
+  /**
+    @brief Partizione di un elemento
+
+    @param v elemento
+
+    @return indice della partizione di v
+  */
+  std::size_t part(const value_type &v) const
+  {
+    unsigned long long mixed = static_cast<unsigned long long>(hash(v)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>((mixed >> 32) % left.size());
+  }
+
+  /**
+    @brief Esegue op(p) per ogni partizione, una per thread
+
+    Se un thread lancia un'eccezione, la prima viene rilanciata dopo aver atteso tutti i thread.
+
+    @param op funzione da eseguire su ogni partizione
+
+    @throw std::system_error se non e' possibile creare un thread
+  */
+  template <typename Op>
+  void run(Op op)
+  {
+    const std::size_t parts = left.size();
+    std::vector<std::exception_ptr> errors(parts);
+    std::vector<std::thread> workers;
+    workers.reserve(parts);
+
+    auto task = [&](std::size_t p)
+    {
+      SET_TRY
+      {
+        op(p);
+      }
+      SET_CATCH_ALL
+      {
+#if SET_EXCEPTIONS
+        errors[p] = std::current_exception();
+#endif
+      }
+    };
+    SET_TRY
+    {
+      for (std::size_t p = 1; p < parts; ++p)
+        workers.push_back(std::thread(task, p));
+    }
+    SET_CATCH_ALL
+    {
+      // i thread avviati usano errors e op: vanno attesi prima di uscire
+      for (std::size_t p = 0; p < workers.size(); ++p)
+        workers[p].join();
+      SET_RETHROW();
+    }
+    task(0);
+    for (std::size_t p = 0; p < workers.size(); ++p)
+      workers[p].join();
+
+#if SET_EXCEPTIONS
+    for (std::size_t p = 0; p < parts; ++p)
+      if (errors[p])
+        std::rethrow_exception(errors[p]);
+#endif
+  }
+
+  /**
+    @brief Set con tutti i risultati parziali
+
+    Costruisce il risultato in un unico oggetto restituito per valore, cosi' il Set non viene
+    copiato (i Set non hanno move constructor e la copia costa O(n)).
+
+    @return Set che contiene i risultati di tutte le partizioni
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename SetT>
+  SetT result() const
+  {
+    SetT out_set;
+    collect(out_set);
+    return out_set;
+  }
+
+  /**
+    @brief Numero totale di elementi nei risultati parziali
+
+    @return somma delle dimensioni di out
+  */
+  std::size_t total() const
+  {
+    std::size_t n = 0;
+    for (std::size_t p = 0; p < out.size(); ++p)
+      n += out[p].size();
+    return n;
+  }
+
+  /**
+    @brief Concatena i risultati parziali in un Set
+
+    Versione generica: add su ogni elemento.
+
+    @param result Set vuoto di destinazione
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename E, typename S>
+  void collect(Set<T, E, S> &result) const
+  {
+    for (std::size_t p = 0; p < out.size(); ++p)
+      for (std::size_t i = 0; i < out[p].size(); ++i)
+        result.add(out[p][i]);
+  }
+
+  /**
+    @brief Concatena i risultati parziali in un FlatSet con un solo ordinamento
+
+    Le add una alla volta costerebbero O(n) ciascuna (inserimento nel vettore ordinato).
+
+    @param result Set vuoto di destinazione
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename E, typename L>
+  void collect(Set<T, E, FlatStorage<L> > &result) const
+  {
+    std::vector<value_type> all;
+    all.reserve(total());
+    for (std::size_t p = 0; p < out.size(); ++p)
+      all.insert(all.end(), out[p].begin(), out[p].end());
+    result.insert(all.begin(), all.end());
+  }
+
+  /**
+    @brief Concatena i risultati parziali in un OpenHashSet dimensionato una sola volta
+
+    @param result Set vuoto di destinazione
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename E, typename H>
+  void collect(Set<T, E, HashStorage<H> > &result) const
+  {
+    result.reserve(static_cast<unsigned int>(total()));
+    for (std::size_t p = 0; p < out.size(); ++p)
+      result.insert(out[p].begin(), out[p].end());
+  }
+
+  /**
+    @brief Concatena i risultati parziali nel Set a lista senza controlli di duplicati
+
+    @param result Set vuoto di destinazione
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename E>
+  void collect(Set<T, E, ListStorage> &result) const
+  {
+    result.reserve(static_cast<unsigned int>(total()));
+    for (std::size_t p = 0; p < out.size(); ++p)
+      result.insert_unique(out[p].begin(), out[p].end());
+  }
+};
+
+/**
+  @brief Numero di partizioni da usare
+
+  @param policy parametri delle operazioni parallele
+
+  @return numero di partizioni (almeno 1)
+*/
+inline unsigned int parallel_parts(const parallel_policy &policy)
+{
+  unsigned int parts = policy.threads != 0 ? policy.threads : std::thread::hardware_concurrency();
+  return parts != 0 ? parts : 1;
+}
+
+/**
+    @brief Unione parallela di due Set
+
+    Sotto policy.threshold elementi (o con un solo thread) equivale a set1 + set2.
+
+    @param set1 primo Set da unire
+    @param set2 secondo Set da unire
+    @param policy numero di thread e soglia della versione seriale
+    @param hash funtore di hash coerente con Equals
+
+    @return Set che contiene gli elementi di entrambi i Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename S, typename Hash = std::hash<typename std::remove_cv<T>::type> >
+Set<T, E, S> parallel_union(const Set<T, E, S> &set1, const Set<T, E, S> &set2,
+                            const parallel_policy &policy = parallel_policy(), Hash hash = Hash())
+{
+  unsigned int parts = parallel_parts(policy);
+  if (parts == 1 || set1.size() + set2.size() < policy.threshold)
+    return set1 + set2;
+
+  typedef set_partitions<T, E, Hash> partitions;
+  partitions pt(set1, set2, parts, hash);
+  pt.run([&pt](std::size_t p)
+         {
+           typename partitions::table left(pt.left[p].begin(), pt.left[p].end(), pt.hash);
+           std::vector<std::size_t> rep;
+           left.insert_all(rep);
+
+           std::vector<typename partitions::value_type> &out = pt.out[p];
+           out = pt.left[p];
+           for (std::size_t i = 0; i < pt.right[p].size(); ++i)
+             if (left.find(pt.right[p][i], pt.hash(pt.right[p][i])) == left.vals.size())
+               out.push_back(pt.right[p][i]); });
+
+  return pt.template result<Set<T, E, S> >();
+}
+
+/**
+    @brief Intersezione parallela di due Set
+
+    Sotto policy.threshold elementi (o con un solo thread) equivale a set1 - set2.
+
+    @param set1 primo Set da intersecare
+    @param set2 secondo Set da intersecare
+    @param policy numero di thread e soglia della versione seriale
+    @param hash funtore di hash coerente con Equals
+
+    @return Set che contiene gli elementi comuni ad entrambi i Set
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename S, typename Hash = std::hash<typename std::remove_cv<T>::type> >
+Set<T, E, S> parallel_intersection(const Set<T, E, S> &set1, const Set<T, E, S> &set2,
+                                   const parallel_policy &policy = parallel_policy(), Hash hash = Hash())
+{
+  unsigned int parts = parallel_parts(policy);
+  if (parts == 1 || set1.size() + set2.size() < policy.threshold)
+    return set1 - set2;
+
+  typedef set_partitions<T, E, Hash> partitions;
+  partitions pt(set1, set2, parts, hash);
+  pt.run([&pt](std::size_t p)
+         {
+           // tabella sulla partizione piu' piccola, scansione della piu' grande
+           bool small_left = pt.left[p].size() < pt.right[p].size();
+           const std::vector<typename partitions::value_type> &build = small_left ? pt.left[p] : pt.right[p];
+           const std::vector<typename partitions::value_type> &probe = small_left ? pt.right[p] : pt.left[p];
+
+           typename partitions::table tab(build.begin(), build.end(), pt.hash);
+           std::vector<std::size_t> rep;
+           tab.insert_all(rep);
+           for (std::size_t i = 0; i < probe.size(); ++i)
+             if (tab.find(probe[i], pt.hash(probe[i])) != tab.vals.size())
+               pt.out[p].push_back(probe[i]); });
+
+  return pt.template result<Set<T, E, S> >();
+}
+
+/**
+    @brief Differenza parallela di due Set
+
+    Sotto policy.threshold elementi (o con un solo thread) viene calcolata serialmente
+    con filter_out e find.
+
+    @param set1 Set di partenza
+    @param set2 Set degli elementi da escludere
+    @param policy numero di thread e soglia della versione seriale
+    @param hash funtore di hash coerente con Equals
+
+    @return Set che contiene gli elementi di set1 che non sono in set2
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename S, typename Hash = std::hash<typename std::remove_cv<T>::type> >
+Set<T, E, S> parallel_difference(const Set<T, E, S> &set1, const Set<T, E, S> &set2,
+                                 const parallel_policy &policy = parallel_policy(), Hash hash = Hash())
+{
+  unsigned int parts = parallel_parts(policy);
+  if (parts == 1 || set1.size() + set2.size() < policy.threshold)
+    return filter_out(set1, [&set2](const T &v)
+                      { return !set2.find(v); });
+
+  typedef set_partitions<T, E, Hash> partitions;
+  partitions pt(set1, set2, parts, hash);
+  pt.run([&pt](std::size_t p)
+         {
+           typename partitions::table right(pt.right[p].begin(), pt.right[p].end(), pt.hash);
+           std::vector<std::size_t> rep;
+           right.insert_all(rep);
+           for (std::size_t i = 0; i < pt.left[p].size(); ++i)
+             if (right.find(pt.left[p][i], pt.hash(pt.left[p][i])) == right.vals.size())
+               pt.out[p].push_back(pt.left[p][i]); });
+
+  return pt.template result<Set<T, E, S> >();
+}
+
+/**
+    @brief Confronto parallelo (uguaglianza) tra due Set
+
+    Sotto policy.threshold elementi (o con un solo thread) equivale a set1 == set2.
+    Le partizioni terminano appena una di esse trova una differenza.
+
+    @param set1 primo Set da confrontare
+    @param set2 secondo Set da confrontare
+    @param policy numero di thread e soglia della versione seriale
+    @param hash funtore di hash coerente con Equals
+
+    @return true se i due Set contengono gli stessi elementi
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+template <typename T, typename E, typename S, typename Hash = std::hash<typename std::remove_cv<T>::type> >
+bool parallel_equal(const Set<T, E, S> &set1, const Set<T, E, S> &set2,
+                    const parallel_policy &policy = parallel_policy(), Hash hash = Hash())
+{
+  if (set1.size() != set2.size())
+    return false;
+  unsigned int parts = parallel_parts(policy);
+  if (parts == 1 || set1.size() + set2.size() < policy.threshold)
+    return set1 == set2;
+
+  typedef set_partitions<T, E, Hash> partitions;
+  partitions pt(set1, set2, parts, hash);
+  std::atomic<bool> equal(true);
+  pt.run([&pt, &equal](std::size_t p)
+         {
+           if (pt.left[p].size() != pt.right[p].size())
+           {
+             equal = false;
+             return;
+           }
+           typename partitions::table right(pt.right[p].begin(), pt.right[p].end(), pt.hash);
+           std::vector<std::size_t> rep;
+           right.insert_all(rep);
+           for (std::size_t i = 0; i < pt.left[p].size() && equal; ++i)
+             if (right.find(pt.left[p][i], pt.hash(pt.left[p][i])) == right.vals.size())
+               equal = false; });
+  return equal;
+}
+
+#endif
@@ -0,0 +1,264 @@
+#ifndef SETVIEW_H
+#define SETVIEW_H
+
+#include "set.h"
+#include "openhashset.h"
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+/**
+  @brief Modalita' di aggiornamento di una filter_view
+*/
+enum view_mode
+{
+  VIEW_EAGER, ///< la vista viene aggiornata durante ogni add/remove sul Set sorgente
+  VIEW_LAZY   ///< le modifiche vengono lette dal change log alla prima lettura successiva
+};
+
+/**
+  @brief classe filter_view
+
+  Vista materializzata degli elementi di un Set (a lista) che soddisfano un predicato: contiene
+  sempre gli stessi elementi di filter_out(sorgente, pred), ma invece di ricalcolarla ad ogni
+  modifica viene aggiornata in O(1) per ogni add/remove effettiva sulla sorgente, usando il
+  change log della sorgente (attivato dal costruttore se necessario).
+
+  Una sorgente puo' avere piu' viste. In modalita' VIEW_EAGER la vista e' un osservatore del
+  change log e si aggiorna durante la modifica; in modalita' VIEW_LAZY legge le modifiche
+  successive all'ultima sequenza vista quando viene letta. Se le modifiche non sono piu'
+  disponibili (buffer sovrascritto, change log disattivato o sostituito) la vista viene
+  ricostruita con una passata sulla sorgente.
+
+  Il predicato deve dipendere solo dal valore dell'elemento.
+
+  @tparam T tipo degli elementi
+  @tparam Equals funtore di uguaglianza
+  @tparam P predicato booleano sui dati T
+  @tparam Hash funtore di hash coerente con Equals (la vista e' un OpenHashSet)
+*/
+template <typename T, typename Equals, typename P, typename Hash = set_hash>
+class filter_view : private change_listener<typename std::remove_cv<T>::type>
+{
+public:
+  typedef typename std::remove_cv<T>::type value_type;
+  typedef Set<T, Equals, ListStorage> source_set;         ///< Set sorgente
+  typedef Set<T, Equals, HashStorage<Hash> > result_set; ///< elementi della vista
+
+  static const std::size_t DEFAULT_LOG_CAPACITY = 1024; ///< capacita' del change log attivato dalla vista
+
+private:
+  source_set *_source;                                 ///< sorgente, nullptr se e' stata distrutta
+  P _pred;                                             ///< predicato della vista
+  view_mode _mode;                                     ///< modalita' di aggiornamento
+  mutable result_set _set;                             ///< elementi che soddisfano il predicato
+  mutable change_log<value_type> *_log;                ///< change log osservato, nullptr se non e' attivo
+  mutable unsigned long long _seq;                     ///< ultima sequenza applicata (VIEW_LAZY)
+  mutable bool _stale;                                 ///< true se la vista va ricostruita
+  mutable unsigned int _rebuilds;                      ///< passate complete sulla sorgente
+  mutable std::vector<set_change<value_type> > _batch; ///< modifiche lette dal change log (VIEW_LAZY)
+
+  /**
+    @brief Applica una modifica della sorgente alla vista
+
+    @param change modifica della sorgente
+  */
+  void apply(const set_change<value_type> &change) const
+  {
+    if (change.kind == CHANGE_REMOVE)
+      _set.remove(change.val);
+    else if (_pred(change.val))
+      _set.add(change.val);
+  }
+
+  /**
+    @brief Ricalcola la vista con una passata sulla sorgente e si registra sul change log corrente
+  */
+  void rebuild() const
+  {
+    _set.clear();
+    for (typename source_set::const_iterator it = _source->begin(); it != _source->end(); ++it)
+      if (_pred(*it))
+        _set.add(*it);
+    ++_rebuilds;
+
+    if (_log != _source->changes())
+    {
+      _log = _source->changes();
+      if (_log != nullptr)
+        _log->subscribe(const_cast<filter_view *>(this));
+    }
+    _seq = _log != nullptr ? _log->last_sequence() : 0;
+    _stale = (_log == nullptr);
+  }
+
+  void on_change(const set_change<value_type> &change)
+  {
+    if (_mode != VIEW_EAGER || _stale)
+      return;
+    SET_TRY
+    {
+      apply(change);
+      _seq = change.seq;
+    }
+    SET_CATCH_ALL
+    {
+      _stale = true;
+    }
+  }
+
+  void on_detach(bool destroyed)
+  {
+    _log = nullptr;
+    _stale = true;
+    if (destroyed)
+      _source = nullptr;
+  }
+
+public:
+  /**
+    @brief Costruttore: calcola la vista e la collega alla sorgente
+
+    @param source Set sorgente (se non ha un change log ne viene attivato uno di DEFAULT_LOG_CAPACITY)
+    @param pred predicato della vista
+    @param mode modalita' di aggiornamento
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  filter_view(source_set &source, P pred, view_mode mode = VIEW_EAGER)
+      : _source(&source), _pred(pred), _mode(mode), _log(nullptr), _seq(0), _stale(true), _rebuilds(0)
+  {
+    if (source.changes() == nullptr)
+      source.set_change_log(DEFAULT_LOG_CAPACITY);
+    rebuild();
+  }
+
+  filter_view(const filter_view &) = delete;
+  filter_view &operator=(const filter_view &) = delete;
+
+  /**
+    @brief Distruttore: scollega la vista dal change log della sorgente
+  */
+  ~filter_view()
+  {
+    if (_log != nullptr)
+      _log->unsubscribe(this);
+  }
+
+  /**
+    @brief Porta la vista allo stato corrente della sorgente
+
+    In modalita' VIEW_EAGER e' necessario solo dopo un errore o la sostituzione del change log;
+    in modalita' VIEW_LAZY applica le modifiche non ancora lette. Se la sorgente e' stata distrutta
+    la vista mantiene il suo ultimo contenuto.
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void refresh() const
+  {
+    if (_source == nullptr)
+      return;
+    if (_stale || _log == nullptr)
+    {
+      rebuild();
+      return;
+    }
+    if (_mode == VIEW_EAGER)
+      return;
+
+    _batch.clear();
+    if (!_log->changes_since(_seq, _batch))
+    {
+      rebuild();
+      return;
+    }
+    for (std::size_t i = 0; i < _batch.size(); ++i)
+      apply(_batch[i]);
+    _seq = _log->last_sequence();
+  }
+
+  /**
+    @brief Elementi della sorgente che soddisfano il predicato
+
+    @return OpenHashSet aggiornato della vista
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  const result_set &contents() const
+  {
+    refresh();
+    return _set;
+  }
+
+  /**
+    @brief Numero di elementi della vista
+
+    @return numero di elementi della sorgente che soddisfano il predicato
+  */
+  unsigned int size() const
+  {
+    return contents().size();
+  }
+
+  /**
+    @brief Ricerca di un elemento nella vista
+
+    @param val valore da cercare
+
+    @return true se val e' nella sorgente e soddisfa il predicato
+  */
+  bool find(const T &val) const
+  {
+    return contents().find(val);
+  }
+
+  /**
+    @brief Modalita' di aggiornamento
+
+    @return VIEW_EAGER o VIEW_LAZY
+  */
+  view_mode mode() const
+  {
+    return _mode;
+  }
+
+  /**
+    @brief Numero di passate complete sulla sorgente (inclusa quella del costruttore)
+
+    @return numero di ricostruzioni della vista
+  */
+  unsigned int rebuilds() const
+  {
+    return _rebuilds;
+  }
+
+  /**
+    @brief Stampa della vista, nel formato di operator<< dei Set
+
+    @return ostream su cui e' stata scritta la vista
+  */
+  friend std::ostream &operator<<(std::ostream &os, const filter_view &view)
+  {
+    return os << view.contents();
+  }
+};
+
+/**
+  @brief Crea una filter_view deducendo i parametri di template
+
+  @param source Set sorgente
+  @param pred predicato della vista
+  @param mode modalita' di aggiornamento
+
+  @return nuova vista (es. auto view = make_filter_view(set, pred);)
+
+  @throw std::bad_alloc possibile eccezione di allocazione
+*/
+template <typename T, typename E, typename P>
+filter_view<T, E, P> make_filter_view(Set<T, E, ListStorage> &source, P pred, view_mode mode = VIEW_EAGER)
+{
+  return filter_view<T, E, P>(source, pred, mode);
+}
+
+#endif
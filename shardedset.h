@@ -0,0 +1,240 @@
+#ifndef SHARDEDSET_H
+#define SHARDEDSET_H
+
+#include "openhashset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <thread>
+
+/**
+  @brief classe ShardedSet
+
+  Set concorrente: gli elementi sono distribuiti in base all'hash in N shard (potenza di 2),
+  ognuno con il proprio OpenHashSet e il proprio lock lettori-scrittori. add/remove bloccano in
+  scrittura un solo shard, find/contains lo bloccano in lettura: thread che lavorano su shard
+  diversi non si contendono lo stesso lock.
+
+  Le operazioni su tutto il Set (size, clear, snapshot) bloccano tutti gli shard in ordine di
+  indice e vedono quindi uno stato consistente.
+
+  @tparam T tipo degli elementi
+  @tparam Equals funtore di uguaglianza
+  @tparam Hash funtore di hash coerente con Equals
+*/
+template <typename T, typename Equals, typename Hash = set_hash>
+class ShardedSet
+{
+public:
+  typedef Set<T, Equals, HashStorage<Hash> > shard_set; ///< Set di un singolo shard
+
+private:
+  /**
+    @brief Uno shard, allineato alla linea di cache per evitare false condivisioni tra i lock
+  */
+  struct alignas(64) shard
+  {
+    mutable std::shared_mutex lock; ///< lock lettori-scrittori dello shard
+    shard_set set;                  ///< elementi dello shard
+  };
+
+  /**
+    @brief Shard a cui appartiene un valore
+
+    Usa i bit alti dell'hash rimescolato, indipendenti da quelli usati per la cella
+    all'interno dello shard.
+
+    @param val valore o chiave
+
+    @return shard di val
+  */
+  template <typename K>
+  shard &shard_of(const K &val) const
+  {
+    std::uint64_t h = set_mix(static_cast<std::uint64_t>(_hash(val)));
+    return _shards[_shift == 64 ? 0 : static_cast<std::size_t>(h >> _shift)];
+  }
+
+  std::unique_ptr<shard[]> _shards; ///< shard
+  std::size_t _count;               ///< numero di shard (potenza di 2)
+  unsigned int _shift;              ///< 64 - log2(_count)
+  Hash _hash;                       ///< funtore di hash
+
+public:
+  /**
+    @brief Costruttore
+
+    @param shards numero minimo di shard, arrotondato alla potenza di 2 successiva
+                  (0 = 4 * std::thread::hardware_concurrency)
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  explicit ShardedSet(unsigned int shards = 0) : _count(1), _shift(64)
+  {
+    if (shards == 0)
+      shards = 4 * (std::thread::hardware_concurrency() != 0 ? std::thread::hardware_concurrency() : 1);
+    while (_count < shards)
+    {
+      _count *= 2;
+      --_shift;
+    }
+    _shards.reset(new shard[_count]);
+  }
+
+  ShardedSet(const ShardedSet &) = delete;
+  ShardedSet &operator=(const ShardedSet &) = delete;
+
+  /**
+    @brief Numero di shard
+
+    @return numero di shard
+  */
+  std::size_t shards() const
+  {
+    return _count;
+  }
+
+  /**
+    @brief Aggiunge un elemento se non e' gia' presente
+
+    @param val valore da inserire
+
+    @return true se val e' stato aggiunto, false se era gia' presente
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  bool add(const T &val)
+  {
+    shard &s = shard_of(val);
+    std::unique_lock<std::shared_mutex> guard(s.lock);
+    unsigned int before = s.set.size();
+    s.set.add(val);
+    return s.set.size() != before;
+  }
+
+  /**
+    @brief Rimuove (se presente) un elemento
+
+    @param val valore da rimuovere
+
+    @return true se val e' stato rimosso, false altrimenti
+  */
+  bool remove(const T &val)
+  {
+    shard &s = shard_of(val);
+    std::unique_lock<std::shared_mutex> guard(s.lock);
+    return s.set.remove(val);
+  }
+
+  /**
+    @brief Cerca un elemento
+
+    @param val valore da cercare
+
+    @return true se val e' presente, false altrimenti
+  */
+  bool find(const T &val) const
+  {
+    const shard &s = shard_of(val);
+    std::shared_lock<std::shared_mutex> guard(s.lock);
+    return s.set.find(val);
+  }
+
+  /**
+    @brief Verifica se un elemento e' presente (alias di find)
+
+    @param val valore da cercare
+
+    @return true se val e' presente, false altrimenti
+  */
+  bool contains(const T &val) const
+  {
+    return find(val);
+  }
+
+  /**
+    @brief Numero di elementi
+
+    Blocca in lettura tutti gli shard: il risultato corrisponde ad uno stato effettivo del Set.
+
+    @return numero di elementi
+  */
+  unsigned int size() const
+  {
+    std::unique_ptr<std::shared_lock<std::shared_mutex>[]> guards(new std::shared_lock<std::shared_mutex>[_count]);
+    unsigned int total = 0;
+    for (std::size_t i = 0; i < _count; ++i)
+    {
+      guards[i] = std::shared_lock<std::shared_mutex>(_shards[i].lock);
+      total += _shards[i].set.size();
+    }
+    return total;
+  }
+
+  /**
+    @brief Numero di elementi di uno shard
+
+    @param i indice dello shard
+
+    @return numero di elementi dello shard i
+  */
+  unsigned int shard_size(std::size_t i) const
+  {
+    std::shared_lock<std::shared_mutex> guard(_shards[i].lock);
+    return _shards[i].set.size();
+  }
+
+  /**
+    @brief Svuota il Set
+
+    Blocca in scrittura tutti gli shard: nessun thread vede il Set svuotato solo in parte.
+  */
+  void clear()
+  {
+    std::unique_ptr<std::unique_lock<std::shared_mutex>[]> guards(new std::unique_lock<std::shared_mutex>[_count]);
+    for (std::size_t i = 0; i < _count; ++i)
+      guards[i] = std::unique_lock<std::shared_mutex>(_shards[i].lock);
+    for (std::size_t i = 0; i < _count; ++i)
+      _shards[i].set.clear();
+  }
+
+  /**
+    @brief Copia consistente del contenuto
+
+    @return OpenHashSet con gli elementi presenti in un istante
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  shard_set snapshot() const
+  {
+    std::unique_ptr<std::shared_lock<std::shared_mutex>[]> guards(new std::shared_lock<std::shared_mutex>[_count]);
+    unsigned int total = 0;
+    for (std::size_t i = 0; i < _count; ++i)
+    {
+      guards[i] = std::shared_lock<std::shared_mutex>(_shards[i].lock);
+      total += _shards[i].set.size();
+    }
+
+    shard_set result;
+    result.reserve(total);
+    for (std::size_t i = 0; i < _count; ++i)
+      result.insert(_shards[i].set.begin(), _shards[i].set.end());
+    return result;
+  }
+
+  /**
+    @brief Stampa di un ShardedSet (uno stato consistente, nel formato di operator<< dei Set)
+
+    @return ostream su cui e' stato scritto il Set
+  */
+  friend std::ostream &operator<<(std::ostream &os, const ShardedSet &mset)
+  {
+    return os << mset.snapshot();
+  }
+};
+
+#endif
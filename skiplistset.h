@@ -0,0 +1,828 @@
+#ifndef SKIPLISTSET_H
+#define SKIPLISTSET_H
+
+#include "set.h"
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+  @brief classe Set (SkipListStorage)
+
+  La classe implementa un Set di elementi generici T unici ordinati secondo Less come skip list
+  indicizzabile: ogni collegamento di livello i memorizza anche quanti elementi salta (width),
+  quindi oltre a find, add e remove anche le query di rango e di intervallo sono O(log n) attese:
+  lower_bound, upper_bound, equal_range, rank, count_in_range, operator[] / nth.
+
+  L'altezza dei nodi e' scelta con un generatore pseudo-casuale interno (probabilita' 1/4 di
+  salire di livello) con seme fisso: la struttura e' deterministica a parita' di operazioni.
+  Gli iteratori restano validi finche' l'elemento puntato non viene rimosso.
+
+  Less deve essere un ordinamento stretto coerente con Equals: Equals(a, b) se e solo se
+  !Less(a, b) && !Less(b, a).
+*/
+template <typename T, typename Equals, typename Less>
+class Set<T, Equals, SkipListStorage<Less> >
+{
+  typedef typename std::remove_cv<T>::type value_type;
+
+  static const unsigned int MAX_LEVEL = 32; ///< livelli massimi (sufficienti per 4^32 elementi)
+
+  struct node;
+
+  /**
+    @brief Collegamento di un livello: nodo successivo ed elementi saltati per raggiungerlo
+
+    Se next e' nullptr width conta le posizioni fino alla fine del Set (size + 1 - rango).
+  */
+  struct link
+  {
+    node *next;
+    unsigned int width;
+  };
+
+  /**
+    @brief Struttura node
+
+    Valore e altezza; gli height collegamenti sono allocati subito dopo il nodo (links()).
+  */
+  struct node
+  {
+    T val;
+    unsigned int height;
+
+    node(const T &v, unsigned int h) : val(v), height(h) {}
+
+    link *links()
+    {
+      return reinterpret_cast<link *>(reinterpret_cast<char *>(this) + links_offset());
+    }
+
+    const link *links() const
+    {
+      return reinterpret_cast<const link *>(reinterpret_cast<const char *>(this) + links_offset());
+    }
+
+    static std::size_t links_offset()
+    {
+      return (sizeof(node) + alignof(link) - 1) / alignof(link) * alignof(link);
+    }
+  };
+
+  /**
+    @brief Crea un nodo con i suoi collegamenti in un'unica allocazione
+
+    @param val valore da copiare
+    @param height numero di livelli del nodo
+
+    @return nuovo nodo (collegamenti non inizializzati)
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  static node *create_node(const T &val, unsigned int height)
+  {
+    void *raw = ::operator new(node::links_offset() + height * sizeof(link));
+    SET_TRY
+    {
+      return new (raw) node(val, height);
+    }
+    SET_CATCH_ALL
+    {
+      ::operator delete(raw);
+      SET_RETHROW();
+    }
+    return nullptr;
+  }
+
+  /**
+    @brief Distrugge un nodo creato da create_node
+
+    @param p nodo da distruggere
+  */
+  static void destroy_node(node *p)
+  {
+    p->~node();
+    ::operator delete(static_cast<void *>(p));
+  }
+
+  /**
+    @brief Altezza casuale di un nuovo nodo (xorshift, P(h > k) = 4^-k)
+
+    @return altezza tra 1 e MAX_LEVEL
+  */
+  unsigned int random_height()
+  {
+    unsigned int h = 1;
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 7;
+    _rng ^= _rng << 17;
+    unsigned long long bits = _rng;
+    while (h < MAX_LEVEL && (bits & 3) == 0)
+    {
+      ++h;
+      bits >>= 2;
+    }
+    return h;
+  }
+
+  /**
+    @brief Collegamenti di livello i di un nodo, o della testa se p e' nullptr
+
+    @param p nodo (nullptr = testa)
+
+    @return array dei collegamenti
+  */
+  link *links_of(node *p)
+  {
+    return p == nullptr ? _head : p->links();
+  }
+
+  const link *links_of(const node *p) const
+  {
+    return p == nullptr ? _head : p->links();
+  }
+
+  /**
+    @brief Discesa dalla testa fino all'ultimo nodo di ogni livello che precede key
+
+    Un nodo precede key se before(nodo, key) e' vero.
+
+    @param key chiave cercata
+    @param before confronto tra un elemento e la chiave
+    @param update ultimo nodo di ogni livello che precede key (nullptr = testa), se non nullptr
+    @param ranks rango di update[i] (0 = testa), se non nullptr
+
+    @return rango dell'ultimo nodo che precede key (numero di elementi che precedono key)
+  */
+  template <typename K, typename Before>
+  unsigned int descend(const K &key, Before before, node **update, unsigned int *ranks) const
+  {
+    const node *x = nullptr;
+    unsigned int rank = 0;
+    for (unsigned int i = _level; i-- != 0;)
+    {
+      const link *l = links_of(x);
+      while (l[i].next != nullptr && before(l[i].next->val, key))
+      {
+        rank += l[i].width;
+        x = l[i].next;
+        l = x->links();
+      }
+      if (update != nullptr)
+        update[i] = const_cast<node *>(x);
+      if (ranks != nullptr)
+        ranks[i] = rank;
+    }
+    return rank;
+  }
+
+  /**
+    @brief Confronto elemento < chiave (per lower_bound)
+  */
+  struct less_than
+  {
+    const Less &less;
+    template <typename K>
+    bool operator()(const T &a, const K &key) const
+    {
+      return less(a, key);
+    }
+  };
+
+  /**
+    @brief Confronto elemento <= chiave (per upper_bound)
+  */
+  struct not_greater
+  {
+    const Less &less;
+    template <typename K>
+    bool operator()(const T &a, const K &key) const
+    {
+      return !less(key, a);
+    }
+  };
+
+  /**
+    @brief Primo nodo con rango maggiore di rank (rank + 1-esimo elemento)
+
+    @param rank numero di elementi da saltare
+
+    @return nodo in posizione rank (0-based), nullptr se rank >= size
+  */
+  const node *node_at(unsigned int rank) const
+  {
+    if (rank >= _size)
+      return nullptr;
+    const node *x = nullptr;
+    unsigned int pos = 0;
+    for (unsigned int i = _level; i-- != 0;)
+    {
+      const link *l = links_of(x);
+      while (l[i].next != nullptr && pos + l[i].width <= rank + 1)
+      {
+        pos += l[i].width;
+        x = l[i].next;
+        l = x->links();
+      }
+    }
+    return x;
+  }
+
+  /**
+    @brief Scambia il contenuto di due Set
+  */
+  void swap(Set &other)
+  {
+    for (unsigned int i = 0; i < MAX_LEVEL; ++i)
+      std::swap(_head[i], other._head[i]);
+    std::swap(_level, other._level);
+    std::swap(_size, other._size);
+    std::swap(_rng, other._rng);
+  }
+
+  link _head[MAX_LEVEL];   ///< collegamenti della testa
+  unsigned int _level;     ///< livelli in uso (almeno 1)
+  unsigned int _size;      ///< numero di elementi nel Set
+  unsigned long long _rng; ///< stato del generatore delle altezze
+  Equals _equals;          ///< funtore per il confronto di eguaglianza tra dati T
+  Less _less;              ///< funtore di ordinamento tra dati T
+
+  /**
+    @brief Inizializza un Set vuoto
+  */
+  void init()
+  {
+    for (unsigned int i = 0; i < MAX_LEVEL; ++i)
+    {
+      _head[i].next = nullptr;
+      _head[i].width = 1;
+    }
+    _level = 1;
+    _size = 0;
+    _rng = 0x9E3779B97F4A7C15ull;
+  }
+
+public:
+  /**
+    @brief Costruttore di default.
+
+    @post Set vuoto
+  */
+  Set()
+  {
+    init();
+  }
+
+  /**
+    @brief Copy constructor
+
+    Gli elementi di other sono gia' ordinati e distinti: vengono accodati senza ricerche.
+
+    @param other Set da copiare
+
+    @post Set chiamante contiene tutti e soli gli elementi di other.
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  Set(const Set &other)
+  {
+    init();
+    SET_TRY
+    {
+      node *last[MAX_LEVEL];
+      unsigned int last_rank[MAX_LEVEL];
+      for (unsigned int i = 0; i < MAX_LEVEL; ++i)
+      {
+        last[i] = nullptr;
+        last_rank[i] = 0;
+      }
+
+      for (const node *p = other._head[0].next; p != nullptr; p = p->links()[0].next)
+      {
+        unsigned int h = random_height();
+        node *n = create_node(p->val, h);
+        // la lista resta terminata anche se la copia del nodo successivo lancia (clear la percorre)
+        for (unsigned int i = 0; i < h; ++i)
+          n->links()[i].next = nullptr;
+        ++_size;
+        if (h > _level)
+          _level = h;
+        for (unsigned int i = 0; i < h; ++i)
+        {
+          link *l = links_of(last[i]);
+          l[i].next = n;
+          l[i].width = _size - last_rank[i];
+          last[i] = n;
+          last_rank[i] = _size;
+        }
+      }
+      for (unsigned int i = 0; i < _level; ++i)
+      {
+        links_of(last[i])[i].next = nullptr;
+        links_of(last[i])[i].width = _size + 1 - last_rank[i];
+      }
+    }
+    SET_CATCH_ALL
+    {
+      clear();
+      SET_ALLOC_ERROR();
+    }
+  }
+
+  /**
+    @brief Costruttore con coppia di iteratori generici
+
+    @param beg iteratore all'inizio della sequenza
+    @param end iteratore alla fine della sequenza
+
+    @post Set chiamante contiene tutti e soli gli elementi della sequenza tra beg e end
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  template <typename Q>
+  Set(Q beg, Q end)
+  {
+    init();
+    SET_TRY
+    {
+      for (; beg != end; ++beg)
+        add(static_cast<T>(*beg));
+    }
+    SET_CATCH_ALL
+    {
+      clear();
+      SET_ALLOC_ERROR();
+    }
+  }
+
+  /**
+    @brief Operatore di assegnamento
+
+    @param other Set da copiare
+
+    @return reference al Set this
+
+    @post Set chiamante contiene tutti e soli gli elementi di other.
+  */
+  Set &operator=(const Set &other)
+  {
+    if (this != &other)
+    {
+      Set tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  /**
+    @brief Distruttore
+  */
+  ~Set()
+  {
+    clear();
+  }
+
+  /**
+    @brief Svuota il Set
+
+    @post Set vuoto
+  */
+  void clear()
+  {
+    node *p = _head[0].next;
+    while (p != nullptr)
+    {
+      node *next = p->links()[0].next;
+      destroy_node(p);
+      p = next;
+    }
+    unsigned long long rng = _rng;
+    init();
+    _rng = rng;
+  }
+
+  /**
+    @brief Numero di elementi nel Set
+
+    @return numero di elementi nel Set
+  */
+  unsigned int size() const
+  {
+    return _size;
+  }
+
+  /**
+     @brief Operatore di lettura dell'elemento in posizione index (in ordine crescente), O(log n)
+
+     @param index indice dell'elemento da leggere
+
+     @return reference all'elemento in posizione index
+
+     @throw myexcp::myexcp_domain_error se viene passato un Set vuoto
+     @throw myexcp::myexcp_out_of_range se viene passato un indice out of bounds
+   */
+  const T &operator[](int index) const
+  {
+    if (_size == 0)
+      SET_THROW(myexcp_domain_error("Empty Set"));
+    if (index < 0 || static_cast<unsigned int>(index) >= _size)
+      SET_THROW(myexcp_out_of_range("Index out of bounds"));
+    return node_at(index)->val;
+  }
+
+  /**
+    @brief Operatore di confronto (uguaglianza) tra due Set
+
+    Entrambi i Set sono ordinati: basta un confronto elemento per elemento.
+
+    @param other Set da confrontare
+
+    @return true se other e il Set chiamante hanno gli stessi elementi
+  */
+  bool operator==(const Set &other) const
+  {
+    if (_size != other._size)
+      return false;
+    const node *a = _head[0].next, *b = other._head[0].next;
+    for (; a != nullptr; a = a->links()[0].next, b = b->links()[0].next)
+      if (!_equals(a->val, b->val))
+        return false;
+    return true;
+  }
+
+  /**
+    @brief Aggiunge un elemento nel set assicurandosi che non sia gia' presente, O(log n)
+
+    @param val valore da inserire nel set
+
+    @post _size = _size+1 se val non era presente
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void add(const T &val)
+  {
+    node *update[MAX_LEVEL];
+    unsigned int ranks[MAX_LEVEL];
+    less_than before = {_less};
+    unsigned int rank = descend(val, before, update, ranks);
+
+    const node *next = links_of(update[0])[0].next;
+    if (next != nullptr && _equals(next->val, val))
+      return;
+
+    unsigned int h = random_height();
+    node *n = create_node(val, h);
+    for (unsigned int i = _level; i < h; ++i)
+    {
+      update[i] = nullptr;
+      ranks[i] = 0;
+      _head[i].width = _size + 1;
+    }
+    if (h > _level)
+      _level = h;
+
+    link *nl = n->links();
+    for (unsigned int i = 0; i < h; ++i)
+    {
+      link *l = links_of(update[i]);
+      nl[i].next = l[i].next;
+      nl[i].width = l[i].width - (rank - ranks[i]);
+      l[i].next = n;
+      l[i].width = rank - ranks[i] + 1;
+    }
+    for (unsigned int i = h; i < _level; ++i)
+      ++links_of(update[i])[i].width;
+    ++_size;
+  }
+
+  /**
+    @brief Rimuove (se presente) un elemento dal set, O(log n)
+
+    @param val valore da rimuovere dal set
+
+    @return true se val e' stato rimosso, false altrimenti
+  */
+  bool remove(const T &val)
+  {
+    node *update[MAX_LEVEL];
+    less_than before = {_less};
+    descend(val, before, update, nullptr);
+
+    node *x = links_of(update[0])[0].next;
+    if (x == nullptr || !_equals(x->val, val))
+      return false;
+
+    const link *xl = x->links();
+    for (unsigned int i = 0; i < _level; ++i)
+    {
+      link *l = links_of(update[i]);
+      if (l[i].next == x)
+      {
+        l[i].width += xl[i].width - 1;
+        l[i].next = xl[i].next;
+      }
+      else
+        --l[i].width;
+    }
+    destroy_node(x);
+    --_size;
+    while (_level > 1 && _head[_level - 1].next == nullptr)
+      --_level;
+    return true;
+  }
+
+  /**
+    @brief Rimuove tutti gli elementi che soddisfano un predicato
+
+    @param pred predicato booleano sui dati T
+
+    @return numero di elementi rimossi
+  */
+  template <typename P>
+  unsigned int remove_if(P pred)
+  {
+    unsigned int removed = 0;
+    const node *p = _head[0].next;
+    while (p != nullptr)
+    {
+      const node *next = p->links()[0].next;
+      if (pred(p->val))
+        removed += remove(p->val);
+      p = next;
+    }
+    return removed;
+  }
+
+  /**
+    @brief ricerca di un valore nel Set, O(log n)
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool find(const T &val) const
+  {
+    node *update[MAX_LEVEL];
+    less_than before = {_less};
+    descend(val, before, update, nullptr);
+    const node *x = links_of(update[0])[0].next;
+    return x != nullptr && _equals(x->val, val);
+  }
+
+  /**
+    @brief Sinonimo di find
+
+    @param val valore da cercare nel Set
+
+    @return true se valore e' presente nel Set, false altrimenti
+  */
+  bool contains(const T &val) const
+  {
+    return find(val);
+  }
+
+  /**
+    @brief stampa del Set nello standard output
+
+    Overloading dell'operatore << dello standard output per stampa del Set (in ordine crescente)
+
+    @return ostream con il Set da stampare
+  */
+  friend std::ostream &operator<<(std::ostream &os, const Set &mset)
+  {
+    os << "{";
+    for (const node *p = mset._head[0].next; p != nullptr; p = p->links()[0].next)
+    {
+      if (p != mset._head[0].next)
+        os << ", ";
+      os << p->val;
+    }
+    os << "}";
+    return os;
+  }
+
+  /**
+  @brief classe const_iterator
+
+  Classe interna di iteratori costanti forward per iterare sul Set in ordine crescente
+
+  */
+  class const_iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T val_type;
+    typedef typename std::remove_cv<T>::type value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const T *pointer;
+    typedef const T &reference;
+
+    /**
+      @brief Costruttore di default.
+
+      @post _ptr = nullptr
+    */
+    const_iterator() : _ptr(nullptr) {}
+
+    /**
+      @brief Operatore di dereferenziamento
+
+      @return reference al valore dell'elemento puntato
+
+      @throw myexcp::myexcp_domain_error se viene dereferenziato end()
+    */
+    reference operator*() const
+    {
+#if SET_ITERATOR_CHECKS
+      if (_ptr == nullptr)
+        SET_THROW(myexcp_domain_error("Dereferencing end()"));
+#endif
+      return _ptr->val;
+    }
+
+    /**
+      @brief Operatore freccia
+
+      @return puntatore al valore dell'elemento puntato
+    */
+    pointer operator->() const
+    {
+      return &(operator*());
+    }
+
+    /**
+      @brief Operatore post incremento
+
+      @return copia dell'iteratore this (prima di essere incrementato)
+    */
+    const_iterator operator++(int)
+    {
+      const_iterator tmp(*this);
+      ++*this;
+      return tmp;
+    }
+
+    /**
+      @brief Operatore pre incremento
+
+      @return reference all'iteratore this (incrementato)
+    */
+    const_iterator &operator++()
+    {
+#if SET_ITERATOR_CHECKS
+      if (_ptr == nullptr)
+        SET_THROW(myexcp_domain_error("Incrementing end()"));
+#endif
+      _ptr = _ptr->links()[0].next;
+      return *this;
+    }
+
+    /**
+    @brief Operatore di confronto (uguaglianza) tra due iteratori
+
+    @return true se i due iteratori puntano allo stesso elemento
+    */
+    bool operator==(const const_iterator &other) const
+    {
+      return _ptr == other._ptr;
+    }
+
+    /**
+    @brief Operatore di confronto (disuguaglianza) tra due iteratori
+
+    @return true se i due iteratori non puntano allo stesso elemento
+    */
+    bool operator!=(const const_iterator &other) const
+    {
+      return _ptr != other._ptr;
+    }
+
+  private:
+    const node *_ptr; ///< nodo puntato, nullptr = end()
+
+    friend class Set;
+
+    explicit const_iterator(const node *p) : _ptr(p) {}
+  };
+
+  /**
+      @brief Iteratore all'inizio del Set
+
+      @return copia dell'iteratore all'elemento minimo del Set
+  */
+  const_iterator begin() const
+  {
+    return const_iterator(_head[0].next);
+  }
+
+  /**
+      @brief Iteratore alla fine del Set
+
+      @return copia dell'iteratore alla fine del Set
+  */
+  const_iterator end() const
+  {
+    return const_iterator(nullptr);
+  }
+
+  /**
+    @brief Primo elemento non minore di key, O(log n)
+
+    @param key chiave (confrontabile con T tramite Less)
+
+    @return iteratore al primo elemento >= key, end() se non esiste
+  */
+  template <typename K>
+  const_iterator lower_bound(const K &key) const
+  {
+    node *update[MAX_LEVEL];
+    less_than before = {_less};
+    descend(key, before, update, nullptr);
+    return const_iterator(links_of(update[0])[0].next);
+  }
+
+  /**
+    @brief Primo elemento maggiore di key, O(log n)
+
+    @param key chiave (confrontabile con T tramite Less)
+
+    @return iteratore al primo elemento > key, end() se non esiste
+  */
+  template <typename K>
+  const_iterator upper_bound(const K &key) const
+  {
+    node *update[MAX_LEVEL];
+    not_greater before = {_less};
+    descend(key, before, update, nullptr);
+    return const_iterator(links_of(update[0])[0].next);
+  }
+
+  /**
+    @brief Intervallo degli elementi equivalenti a key (al piu' uno), O(log n)
+
+    @param key chiave (confrontabile con T tramite Less)
+
+    @return coppia (lower_bound(key), upper_bound(key))
+  */
+  template <typename K>
+  std::pair<const_iterator, const_iterator> equal_range(const K &key) const
+  {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  /**
+    @brief Numero di elementi minori di key (posizione di lower_bound(key)), O(log n)
+
+    @param key chiave (confrontabile con T tramite Less)
+
+    @return rango di key
+  */
+  template <typename K>
+  unsigned int rank(const K &key) const
+  {
+    less_than before = {_less};
+    return descend(key, before, nullptr, nullptr);
+  }
+
+  /**
+    @brief Numero di elementi in [lo, hi), O(log n)
+
+    @param lo estremo inferiore (incluso)
+    @param hi estremo superiore (escluso)
+
+    @return numero di elementi x con lo <= x < hi (0 se hi <= lo)
+  */
+  template <typename K>
+  unsigned int count_in_range(const K &lo, const K &hi) const
+  {
+    unsigned int a = rank(lo), b = rank(hi);
+    return b > a ? b - a : 0;
+  }
+
+  /**
+    @brief Elemento in posizione index in ordine crescente, O(log n)
+
+    @param index posizione (0 = minimo)
+
+    @return iteratore all'elemento, end() se index >= size()
+  */
+  const_iterator nth(unsigned int index) const
+  {
+    return const_iterator(node_at(index));
+  }
+};
+
+/**
+  @brief Set ordinato a skip list
+
+  @tparam T tipo degli elementi
+  @tparam Equals funtore di uguaglianza
+  @tparam Less ordinamento stretto coerente con Equals
+*/
+template <typename T, typename Equals, typename Less = std::less<void> >
+using SkipListSet = Set<T, Equals, SkipListStorage<Less> >;
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+
+/**
+  @brief Politica di gestione degli errori dei Set
+
+  SET_EXCEPTIONS vale 1 se le eccezioni sono abilitate e SET_NO_EXCEPTIONS non e' definito.
+  Con SET_EXCEPTIONS == 0 gli header dei Set non contengono throw, try/catch ne' stampe su
+  std::cerr e compilano con -fno-exceptions: gli errori che lancerebbero un'eccezione
+  (indice fuori dai limiti, dereferenziamento di end(), ...) terminano il programma con
+  std::abort. In questa modalita' vanno usate le varianti try_add, try_at e contains.
+*/
+#if defined(SET_NO_EXCEPTIONS) || !(defined(__cpp_exceptions) || defined(__EXCEPTIONS))
+#define SET_EXCEPTIONS 0
+#else
+#define SET_EXCEPTIONS 1
+#endif
+
+#if SET_EXCEPTIONS
+#define SET_THROW(e) throw(e)
+#define SET_TRY try
+#define SET_CATCH_ALL catch (...)
+#define SET_RETHROW() throw
+#define SET_ALLOC_ERROR()                                       \
+  do                                                            \
+  {                                                             \
+    std::cerr << ("   %%%   ERROR IN MEMORY ALLOCATION   %%%"); \
+    throw;                                                      \
+  } while (0)
+#else
+#define SET_THROW(e) std::abort()
+#define SET_TRY if (true)
+#define SET_CATCH_ALL else
+#define SET_RETHROW() ((void)0)
+#define SET_ALLOC_ERROR() ((void)0)
+#endif
+
+/**
+  @brief Esito delle operazioni senza eccezioni (try_add, ...)
+*/
+enum set_status
+{
+  SET_OK,           ///< operazione eseguita
+  SET_EXISTS,       ///< elemento gia' presente, il Set non e' stato modificato
+  SET_OUT_OF_RANGE, ///< indice fuori dai limiti (o Set vuoto)
+  SET_NO_MEMORY     ///< allocazione fallita, il Set non e' stato modificato
+};
+
+/**
+  @brief Livello di controllo degli iteratori dei Set
+
+  - 0: nessun controllo; gli iteratori costano quanto un puntatore, tranne quelli del Set a lista
+    che portano anche il collegamento al precedente e il Set usati da erase
+  - 1: dereferenziare o incrementare end() lancia myexcp_domain_error (default)
+  - 2: come 1, inoltre gli iteratori del Set a lista invalidati da remove, remove_if, clear o
+    assegnamento lanciano myexcp_domain_error; l'iteratore del Set a lista contiene anche la
+    generazione del Set
+
+  Il default non dipende da NDEBUG: unita' di compilazione di debug e di release collegate
+  insieme vedono lo stesso iteratore. Un livello diverso va scelto esplicitamente (es.
+  -DSET_ITERATOR_CHECKS=2) e deve essere lo stesso in tutte le unita' di compilazione.
+*/
+#ifndef SET_ITERATOR_CHECKS
+#define SET_ITERATOR_CHECKS 1
+#endif
+
+/**
+  @brief Funtore di hash generico
+
+  Applica std::hash<K> al tipo dell'argomento. E' l'hash di default degli storage basati su hash.
+*/
+struct set_hash
+{
+  template <typename K>
+  std::size_t operator()(const K &key) const
+  {
+    return std::hash<K>()(key);
+  }
+};
+
+/**
+  @brief Finalizzatore a 64 bit di splitmix64, utilizzabile anche in espressioni costanti
+
+  Rimescola un hash prima di usarne i bit (StaticSet, FrozenSet, MinHash, HyperLogLog).
+
+  @param x valore da rimescolare
+
+  @return valore con i bit ben distribuiti
+*/
+constexpr std::uint64_t set_mix(std::uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+/**
+  @brief Storage a lista concatenata semplice (set.h)
+
+  Inserimento in testa, ricerca lineare, nessun requisito su T oltre a Equals.
+*/
+struct ListStorage
+{
+};
+
+/**
+  @brief Storage a lista concatenata con hash memorizzato nei nodi (hashedset.h)
+
+  @tparam Hash funtore di hash coerente con Equals
+*/
+template <typename Hash = set_hash>
+struct CachedHashStorage
+{
+};
+
+/**
+  @brief Storage a vettore ordinato (flatset.h)
+
+  @tparam Less ordinamento stretto coerente con Equals
+*/
+template <typename Less = std::less<void> >
+struct FlatStorage
+{
+};
+
+/**
+  @brief Storage a tabella hash a indirizzamento aperto (openhashset.h)
+
+  @tparam Hash funtore di hash coerente con Equals
+*/
+template <typename Hash = set_hash>
+struct HashStorage
+{
+};
+
+/**
+  @brief Storage a skip list ordinata e indicizzabile (skiplistset.h)
+
+  @tparam Less ordinamento stretto coerente con Equals
+*/
+template <typename Less = std::less<void> >
+struct SkipListStorage
+{
+};
+
+/**
+  @brief Storage a bitmap compressa roaring, solo per T = int (roaring.h)
+*/
+struct BitmapStorage
+{
+};
+
+/**
+  @brief Storage adattivo (adaptiveset.h)
+
+  Parte come lista concatenata (ListStorage) e passa a Large quando il Set cresce o riceve molte
+  ricerche; puo' tornare alla lista quando si svuota.
+
+  @tparam Large storage usato per i Set grandi (es. HashStorage<> o FlatStorage<>)
+*/
+template <typename Large = HashStorage<> >
+struct AdaptiveStorage
+{
+};
+
+/**
+  @brief Nome leggibile di uno storage, per introspezione e stampa
+*/
+template <typename Storage>
+struct storage_name;
+
+template <>
+struct storage_name<ListStorage>
+{
+  static const char *value() { return "list"; }
+};
+
+template <typename Hash>
+struct storage_name<CachedHashStorage<Hash> >
+{
+  static const char *value() { return "cached-hash list"; }
+};
+
+template <typename Less>
+struct storage_name<FlatStorage<Less> >
+{
+  static const char *value() { return "flat"; }
+};
+
+template <typename Hash>
+struct storage_name<HashStorage<Hash> >
+{
+  static const char *value() { return "hash"; }
+};
+
+template <typename Less>
+struct storage_name<SkipListStorage<Less> >
+{
+  static const char *value() { return "skip list"; }
+};
+
+template <>
+struct storage_name<BitmapStorage>
+{
+  static const char *value() { return "bitmap"; }
+};
+
+template <typename Large>
+struct storage_name<AdaptiveStorage<Large> >
+{
+  static const char *value() { return "adaptive"; }
+};
+
+/**
+  @brief classe Set
+
+  Set di elementi generici T unici (senza ripetizione); Equals confronta due elementi e restituisce
+  true se sono uguali. Storage sceglie la struttura dati: ogni storage e' una specializzazione
+  parziale di Set definita nel proprio header.
+
+  Ogni specializzazione offre la stessa interfaccia:
+  - costruttore di default, copy constructor, costruttore con coppia di iteratori, operator=
+  - add, remove, find, contains, clear, size
+  - operator[], operator==, operator<<
+  - const_iterator (almeno forward), begin, end
+
+  Le funzioni libere filter_out, operator+ e operator- hanno una versione generica in set.h basata
+  solo su iteratori e add; uno storage puo' definirne una versione piu' specializzata (es. fusione
+  di vettori ordinati, OR/AND tra bitmap) che viene scelta a tempo di compilazione.
+*/
+template <typename T, typename Equals, typename Storage = ListStorage>
+class Set;
+
+#endif
@@ -0,0 +1,465 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "storage.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+  @brief classe work_stealing_pool
+
+  Pool di thread con una coda (deque) per thread. Un thread esegue i task della propria coda
+  partendo dal fondo (l'ultimo inserito, ancora in cache) e, quando la sua coda e' vuota, ruba
+  il task piu' vecchio dalla coda di un altro thread. I task inviati da un thread del pool finiscono
+  nella sua coda; quelli inviati dall'esterno vengono distribuiti a turno tra le code.
+
+  Espone contatori per il bilanciamento: furti, task eseguiti, profondita' delle code.
+*/
+class work_stealing_pool
+{
+  typedef std::function<void()> task;
+
+  /**
+    @brief Coda di un thread
+  */
+  struct worker_queue
+  {
+    std::mutex lock;       ///< protegge tasks
+    std::deque<task> tasks; ///< task in attesa
+  };
+
+  /**
+    @brief Thread corrente: pool di appartenenza e indice della sua coda
+  */
+  struct worker_id
+  {
+    const work_stealing_pool *pool;
+    std::size_t index;
+  };
+
+  static worker_id &current()
+  {
+    static thread_local worker_id id = {nullptr, 0};
+    return id;
+  }
+
+  /**
+    @brief Inserisce un task in fondo alla coda i
+
+    @param i indice della coda
+    @param t task da inserire
+  */
+  void push(std::size_t i, task t)
+  {
+    std::size_t depth;
+    {
+      std::lock_guard<std::mutex> guard(_queues[i].lock);
+      _queues[i].tasks.push_back(std::move(t));
+      depth = _queues[i].tasks.size();
+    }
+    std::size_t max = _max_depth.load();
+    while (depth > max && !_max_depth.compare_exchange_weak(max, depth))
+    {
+    }
+    {
+      std::lock_guard<std::mutex> guard(_idle_lock);
+      ++_queued;
+    }
+    _idle.notify_one();
+  }
+
+  /**
+    @brief Estrae un task: prima dal fondo della coda i, poi dalla testa delle altre code
+
+    @param i indice della coda del thread
+    @param t task estratto
+
+    @return true se e' stato estratto un task
+  */
+  bool pop(std::size_t i, task &t)
+  {
+    {
+      std::lock_guard<std::mutex> guard(_queues[i].lock);
+      if (!_queues[i].tasks.empty())
+      {
+        t = std::move(_queues[i].tasks.back());
+        _queues[i].tasks.pop_back();
+        return true;
+      }
+    }
+    for (std::size_t k = 1; k < _queues.size(); ++k)
+    {
+      worker_queue &victim = _queues[(i + k) % _queues.size()];
+      std::lock_guard<std::mutex> guard(victim.lock);
+      if (!victim.tasks.empty())
+      {
+        t = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        ++_steals;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+    @brief Ciclo di un thread del pool
+
+    Il thread dorme su _idle finche' non c'e' un task non ancora prenotato, lo prenota
+    decrementando _queued e solo dopo lo estrae: un thread sveglio trova sempre un task e non
+    gira a vuoto mentre un altro thread sta estraendo l'ultimo.
+
+    @param i indice della coda del thread
+  */
+  void run(std::size_t i)
+  {
+    current().pool = this;
+    current().index = i;
+
+    while (true)
+    {
+      {
+        std::unique_lock<std::mutex> guard(_idle_lock);
+        _idle.wait(guard, [this]
+                   { return _stop || _queued != 0; });
+        if (_queued == 0)
+          return;
+        --_queued;
+      }
+
+      // le code contengono almeno un task per ogni prenotazione: se un altro thread ha preso
+      // quello visto per primo ne resta un altro in una coda gia' visitata
+      task t;
+      while (!pop(i, t))
+        std::this_thread::yield();
+      execute(t);
+    }
+  }
+
+  /**
+    @brief Chiede la chiusura ai thread e attende quelli avviati (che eseguono i task rimasti)
+  */
+  void shutdown()
+  {
+    {
+      std::lock_guard<std::mutex> guard(_idle_lock);
+      _stop = true;
+    }
+    _idle.notify_all();
+    for (std::size_t i = 0; i < _threads.size(); ++i)
+      _threads[i].join();
+  }
+
+  /**
+    @brief Esegue un task e aggiorna i contatori; la prima eccezione viene conservata per wait()
+
+    @param t task da eseguire
+  */
+  void execute(task &t)
+  {
+    SET_TRY
+    {
+      t();
+    }
+    SET_CATCH_ALL
+    {
+#if SET_EXCEPTIONS
+      std::lock_guard<std::mutex> guard(_done_lock);
+      if (!_error)
+        _error = std::current_exception();
+#endif
+    }
+    ++_executed;
+
+    std::lock_guard<std::mutex> guard(_done_lock);
+    if (--_pending == 0)
+      _done.notify_all();
+  }
+
+  std::vector<worker_queue> _queues;     ///< una coda per thread
+  std::vector<std::thread> _threads;     ///< thread del pool
+  std::atomic<std::size_t> _next;        ///< prossima coda per i task inviati dall'esterno
+  std::atomic<unsigned long long> _steals;   ///< task rubati dalla coda di un altro thread
+  std::atomic<unsigned long long> _executed; ///< task eseguiti
+  std::atomic<std::size_t> _max_depth;   ///< massima profondita' raggiunta da una coda
+
+  std::mutex _idle_lock;            ///< protegge _queued e _stop
+  std::condition_variable _idle;    ///< segnalata quando arriva un task o alla chiusura
+  std::size_t _queued;              ///< task nelle code non ancora prenotati da un thread
+  bool _stop;                       ///< true quando il pool viene distrutto
+
+  std::mutex _done_lock;            ///< protegge _pending e _error
+  std::condition_variable _done;    ///< segnalata quando _pending torna a 0
+  std::size_t _pending;             ///< task inviati e non ancora terminati
+  std::exception_ptr _error;        ///< prima eccezione lanciata da un task
+
+public:
+  /**
+    @brief Costruttore
+
+    @param threads numero di thread (0 = std::thread::hardware_concurrency)
+
+    @throw std::system_error se non e' possibile creare un thread
+  */
+  explicit work_stealing_pool(unsigned int threads = 0)
+      : _queues(threads != 0 ? threads : (std::thread::hardware_concurrency() != 0 ? std::thread::hardware_concurrency() : 1)),
+        _next(0), _steals(0), _executed(0), _max_depth(0), _queued(0), _stop(false), _pending(0)
+  {
+    _threads.reserve(_queues.size());
+    SET_TRY
+    {
+      for (std::size_t i = 0; i < _queues.size(); ++i)
+        _threads.push_back(std::thread(&work_stealing_pool::run, this, i));
+    }
+    SET_CATCH_ALL
+    {
+      // i thread gia' avviati usano this: vanno fermati prima che l'eccezione distrugga il pool
+      shutdown();
+      SET_RETHROW();
+    }
+  }
+
+  work_stealing_pool(const work_stealing_pool &) = delete;
+  work_stealing_pool &operator=(const work_stealing_pool &) = delete;
+
+  /**
+    @brief Distruttore: esegue i task rimasti e termina i thread
+  */
+  ~work_stealing_pool()
+  {
+    shutdown();
+  }
+
+  /**
+    @brief Invia un task al pool
+
+    @param t task da eseguire
+
+    @throw std::bad_alloc possibile eccezione di allocazione
+  */
+  void submit(task t)
+  {
+    {
+      std::lock_guard<std::mutex> guard(_done_lock);
+      ++_pending;
+    }
+    if (current().pool == this)
+      push(current().index, std::move(t));
+    else
+      push(_next++ % _queues.size(), std::move(t));
+  }
+
+  /**
+    @brief Attende la fine di tutti i task inviati
+
+    Non va chiamata da un task del pool.
+
+    @throw eccezione lanciata da un task (la prima), che viene poi dimenticata
+  */
+  void wait()
+  {
+    std::unique_lock<std::mutex> guard(_done_lock);
+    _done.wait(guard, [this]
+               { return _pending == 0; });
+#if SET_EXCEPTIONS
+    if (_error)
+    {
+      std::exception_ptr error = _error;
+      _error = nullptr;
+      std::rethrow_exception(error);
+    }
+#endif
+  }
+
+  /**
+    @brief Numero di thread del pool
+
+    @return numero di thread
+  */
+  std::size_t threads() const
+  {
+    return _queues.size();
+  }
+
+  /**
+    @brief Numero di task rubati dalla coda di un altro thread
+
+    @return numero di furti dalla creazione del pool
+  */
+  unsigned long long steals() const
+  {
+    return _steals.load();
+  }
+
+  /**
+    @brief Numero di task eseguiti
+
+    @return numero di task eseguiti dalla creazione del pool
+  */
+  unsigned long long executed() const
+  {
+    return _executed.load();
+  }
+
+  /**
+    @brief Numero di task in attesa nella coda di un thread
+
+    @param i indice del thread
+
+    @return profondita' corrente della coda i
+  */
+  std::size_t queue_depth(std::size_t i)
+  {
+    std::lock_guard<std::mutex> guard(_queues[i].lock);
+    return _queues[i].tasks.size();
+  }
+
+  /**
+    @brief Massima profondita' raggiunta da una coda
+
+    @return numero massimo di task in attesa osservato in una singola coda
+  */
+  std::size_t max_queue_depth() const
+  {
+    return _max_depth.load();
+  }
+};
+
+/**
+  @brief Applica op ad ogni elemento di una sequenza, un task per elemento
+
+  @param pool pool su cui eseguire i task
+  @param first iteratore all'inizio della sequenza
+  @param last iteratore alla fine della sequenza
+  @param op operazione da applicare (deve poter essere eseguita in parallelo)
+
+  @return risultati di op nell'ordine della sequenza
+
+  @throw eccezione lanciata da op (la prima)
+*/
+template <typename Iter, typename Op>
+std::vector<decltype(std::declval<Op &>()(*std::declval<Iter &>()))>
+pool_map(work_stealing_pool &pool, Iter first, Iter last, Op op)
+{
+  typedef decltype(op(*first)) result_type;
+  // un elemento separato per task: std::vector<bool> impacchetterebbe i risultati nello stesso byte
+  const std::size_t n = std::distance(first, last);
+  std::unique_ptr<result_type[]> buffer(new result_type[n]);
+
+  for (std::size_t i = 0; first != last; ++first, ++i)
+  {
+    Iter it = first;
+    result_type *slot = &buffer[i];
+    pool.submit([slot, &op, it]
+                { *slot = op(*it); });
+  }
+  pool.wait();
+
+  std::vector<result_type> results;
+  results.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+    results.push_back(std::move(buffer[i]));
+  return results;
+}
+
+/**
+  @brief filter_out su ogni Set di una sequenza
+
+  @param pool pool su cui eseguire i task
+  @param first iteratore al primo Set
+  @param last iteratore alla fine della sequenza
+  @param pred predicato booleano filtro
+
+  @return Set filtrati, nell'ordine della sequenza
+*/
+template <typename Iter, typename P>
+std::vector<typename std::iterator_traits<Iter>::value_type>
+pool_filter(work_stealing_pool &pool, Iter first, Iter last, P pred)
+{
+  typedef typename std::iterator_traits<Iter>::value_type set_type;
+  return pool_map(pool, first, last, [&pred](const set_type &s)
+                  { return filter_out(s, pred); });
+}
+
+/**
+  @brief Unione di ogni coppia di Set di una sequenza di coppie
+
+  @param pool pool su cui eseguire i task
+  @param first iteratore alla prima coppia (std::pair di puntatori a Set)
+  @param last iteratore alla fine della sequenza
+
+  @return unioni, nell'ordine della sequenza
+*/
+template <typename Iter>
+auto pool_union(work_stealing_pool &pool, Iter first, Iter last)
+{
+  typedef typename std::iterator_traits<Iter>::value_type pair_type;
+  return pool_map(pool, first, last, [](const pair_type &p)
+                  { return *p.first + *p.second; });
+}
+
+/**
+  @brief Intersezione di ogni coppia di Set di una sequenza di coppie
+
+  @param pool pool su cui eseguire i task
+  @param first iteratore alla prima coppia (std::pair di puntatori a Set)
+  @param last iteratore alla fine della sequenza
+
+  @return intersezioni, nell'ordine della sequenza
+*/
+template <typename Iter>
+auto pool_intersection(work_stealing_pool &pool, Iter first, Iter last)
+{
+  typedef typename std::iterator_traits<Iter>::value_type pair_type;
+  return pool_map(pool, first, last, [](const pair_type &p)
+                  { return *p.first - *p.second; });
+}
+
+/**
+  @brief Confronto (uguaglianza) di tutte le coppie di Set di una collezione
+
+  Viene creato un task per ogni riga della matrice triangolare: le righe hanno lunghezze diverse
+  e il furto di task bilancia il carico tra i thread.
+
+  @param pool pool su cui eseguire i task
+  @param first iteratore al primo Set della collezione (anche forward, es. Set di Set)
+  @param last iteratore alla fine della collezione
+
+  @return matrice n x n per righe: elemento i * n + j vale 1 se i Set i e j sono uguali
+
+  @throw eccezione lanciata da un confronto (la prima)
+*/
+template <typename Iter>
+std::vector<char> pool_equal_pairs(work_stealing_pool &pool, Iter first, Iter last)
+{
+  typedef typename std::iterator_traits<Iter>::value_type set_type;
+  std::vector<const set_type *> sets;
+  for (; first != last; ++first)
+    sets.push_back(&*first);
+
+  const std::size_t n = sets.size();
+  std::vector<char> equal(n * n, 0);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    pool.submit([&sets, &equal, i, n]
+                {
+                  equal[i * n + i] = 1;
+                  for (std::size_t j = i + 1; j < n; ++j)
+                    equal[i * n + j] = equal[j * n + i] = (*sets[i] == *sets[j]); });
+  }
+  pool.wait();
+  return equal;
+}
+
+#endif